@@ -0,0 +1,600 @@
+// ==============================
+// DIGITAL ATTENDANCE SYSTEM - BENCHMARKS
+// ==============================
+// Times the hot paths of main.cpp on deterministic synthetic data and
+// prints one JSON object per line, so results from two builds can be
+// diffed directly.
+//
+//   ./benchmark [--scales=1000,10000,100000] [--sessions=20]
+//               [--dist=70,20,10] [--seed=42] [--repeat=5] [--out=FILE]
+//
+// --dist is the Present,Absent,Late percentage split. Each operation runs
+// --repeat times; min and median wall time are reported. All files are
+// written to a scratch directory that is removed afterwards.
+#define ATTENDANCE_NO_MAIN
+#include "main.cpp"
+
+#include <random>
+
+// Discards everything written to it (used to silence cout while timing)
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct BenchConfig {
+    vector<size_t> scales{1000, 10000, 100000};
+    size_t sessions = 20;
+    int presentPercent = 70;
+    int absentPercent = 20;
+    int latePercent = 10;
+    uint64_t seed = 42;
+    size_t repeat = 5;
+    string outFile;
+};
+
+// Synthetic data generated from a fixed seed
+class DataGenerator {
+private:
+    mt19937_64 rng;
+    const BenchConfig& config;
+
+public:
+    DataGenerator(const BenchConfig& cfg) : rng(cfg.seed), config(cfg) {}
+
+    vector<Student> students(size_t count) {
+        static const char* firstNames[] = {"Kwame", "Ama", "Kojo", "Esi", "Yaw", "Akosua", "Kofi", "Abena"};
+        static const char* lastNames[] = {"Mensah", "Boateng", "Asare", "Ampofo", "Ofori", "Owusu", "Darko"};
+
+        vector<Student> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            char index[32];
+            snprintf(index, sizeof(index), "EE%07zu", i);
+            string name = string(firstNames[rng() % 8]) + " " + lastNames[rng() % 7];
+            result.push_back(Student(index, name));
+        }
+        return result;
+    }
+
+    char status() {
+        int roll = (int)(rng() % 100);
+        if (roll < config.presentPercent) return 'P';
+        if (roll < config.presentPercent + config.absentPercent) return 'A';
+        return 'L';
+    }
+
+    size_t below(size_t n) { return (size_t)(rng() % n); }
+};
+
+class BenchRunner {
+private:
+    const BenchConfig& config;
+    ostream& out;
+    NullBuffer nullBuffer;
+
+public:
+    BenchRunner(const BenchConfig& cfg, ostream& output) : config(cfg), out(output) {}
+
+    // Time fn (run config.repeat times after setup) and emit one result line.
+    // items is the number of records/students/sessions fn processes.
+    void run(const string& op, size_t students, size_t items,
+             const function<void()>& setup, const function<void()>& fn) {
+        vector<double> samples;
+        for (size_t r = 0; r < config.repeat; r++) {
+            if (setup) setup();
+            streambuf* saved = cout.rdbuf(&nullBuffer);
+            auto started = chrono::steady_clock::now();
+            fn();
+            auto elapsed = chrono::steady_clock::now() - started;
+            cout.rdbuf(saved);
+            samples.push_back((double)chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+        }
+        sort(samples.begin(), samples.end());
+        double median = samples[samples.size() / 2];
+
+        out << fixed << setprecision(0)
+            << "{\"op\":\"" << op << "\""
+            << ",\"students\":" << students
+            << ",\"sessions\":" << config.sessions
+            << ",\"items\":" << items
+            << ",\"repeat\":" << config.repeat
+            << ",\"min_ns\":" << samples.front()
+            << ",\"median_ns\":" << median
+            << setprecision(2)
+            << ",\"ns_per_item\":" << (items > 0 ? median / items : median)
+            << "}" << endl;
+    }
+
+    // Emit the size of an encoding next to the size it is compared with
+    void size(const string& op, size_t students, size_t bytes, size_t baselineBytes) {
+        out << "{\"op\":\"" << op << "\""
+            << ",\"students\":" << students
+            << ",\"sessions\":" << config.sessions
+            << ",\"bytes\":" << bytes
+            << ",\"baseline_bytes\":" << baselineBytes
+            << "}" << endl;
+    }
+};
+
+static vector<size_t> parseList(const string& text) {
+    vector<size_t> values;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(stoul(item));
+    }
+    return values;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = eq == string::npos ? "" : arg.substr(eq + 1);
+
+        if (key == "--scales") {
+            config.scales = parseList(value);
+        } else if (key == "--sessions") {
+            config.sessions = stoul(value);
+        } else if (key == "--dist") {
+            vector<size_t> split = parseList(value);
+            if (split.size() != 3 || split[0] + split[1] + split[2] != 100) {
+                cerr << "Error: --dist needs three percentages adding up to 100" << endl;
+                return false;
+            }
+            config.presentPercent = (int)split[0];
+            config.absentPercent = (int)split[1];
+            config.latePercent = (int)split[2];
+        } else if (key == "--seed") {
+            config.seed = stoull(value);
+        } else if (key == "--repeat") {
+            config.repeat = max<size_t>(1, stoul(value));
+        } else if (key == "--out") {
+            config.outFile = value;
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            return false;
+        }
+    }
+    return !config.scales.empty() && config.sessions > 0;
+}
+
+static void benchScale(BenchRunner& bench, const BenchConfig& config, size_t n) {
+    DataGenerator gen(config);
+    vector<Student> roster = gen.students(n);
+
+    StudentRegistry registry;
+    for (const auto& student : roster) registry.add(student);
+
+    // ----- Registration / lookup -----
+    bench.run("registry_add", n, n, nullptr, [&] {
+        StudentRegistry fresh;
+        for (const auto& student : roster) fresh.add(student);
+    });
+
+    vector<string_view> probes;
+    for (size_t i = 0; i < n; i++) probes.push_back(roster[gen.below(n)].getIndex());
+    bench.run("registry_find", n, n, nullptr, [&] {
+        size_t found = 0;
+        for (const auto& idx : probes) found += registry.contains(idx);
+        if (found != probes.size()) cerr << "registry_find: missing students" << endl;
+    });
+
+    // ----- Fuzzy name search (100 partial or misspelled names) -----
+    {
+        vector<string> queries;
+        for (size_t q = 0; q < 100; q++) {
+            string name(roster[gen.below(n)].getName());
+            if (q % 2 == 0) {
+                name.resize(name.size() - 2); // "Kwame Mens"
+            } else {
+                size_t at = 1 + gen.below(name.size() - 2);
+                swap(name[at], name[at + 1]); // "Kwmae Mensah"
+            }
+            queries.push_back(name);
+        }
+
+        bench.run("name_index_build", n, n, nullptr, [&] {
+            StudentRegistry fresh;
+            for (const auto& student : roster) fresh.add(student);
+            fresh.searchByName("", 1);
+        });
+        registry.searchByName("", 1);
+        vector<vector<const Student*>> indexed(queries.size());
+        bench.run("name_search_index", n, queries.size(), nullptr, [&] {
+            for (size_t q = 0; q < queries.size(); q++) {
+                indexed[q].clear();
+                for (const auto& match : registry.searchByName(queries[q], 10)) indexed[q].push_back(match.first);
+            }
+        });
+
+        // The same ranking by scanning every student (best of name and index)
+        vector<vector<const Student*>> scanned(queries.size());
+        bench.run("name_search_bruteforce", n, queries.size(), nullptr, [&] {
+            vector<uint32_t> queryGrams, grams, common;
+            for (size_t q = 0; q < queries.size(); q++) {
+                TrigramIndex::trigrams(queries[q], queryGrams, false);
+                size_t needed = max<size_t>(1, (size_t)ceil(0.5 * queryGrams.size()));
+                vector<TrigramIndex::Match> matches;
+                for (size_t i = 0; i < roster.size(); i++) {
+                    TrigramIndex::Match best{(uint32_t)i, 0, 0};
+                    for (string_view text : {roster[i].getName(), roster[i].getIndex()}) {
+                        TrigramIndex::trigrams(text, grams);
+                        common.clear();
+                        set_intersection(queryGrams.begin(), queryGrams.end(), grams.begin(), grams.end(),
+                                         back_inserter(common));
+                        TrigramIndex::Match match{(uint32_t)i, (uint16_t)common.size(), (uint16_t)grams.size()};
+                        if (TrigramIndex::ranksBefore(match, best)) best = match;
+                    }
+                    if (best.shared >= needed) matches.push_back(best);
+                }
+                size_t limit = min<size_t>(10, matches.size());
+                partial_sort(matches.begin(), matches.begin() + limit, matches.end(), TrigramIndex::ranksBefore);
+                scanned[q].clear();
+                for (size_t k = 0; k < limit; k++) scanned[q].push_back(&registry[matches[k].document]);
+            }
+        });
+        if (indexed != scanned) cerr << "name_search: index and scan disagree" << endl;
+    }
+
+    // ----- loadStudents -----
+    {
+        string contents;
+        for (const auto& student : roster) contents += student.toString() + "\n";
+        writeFileAtomically("students.txt", contents);
+        remove("students.journal");
+
+        NullBuffer quiet;
+        streambuf* saved = cout.rdbuf(&quiet);
+        AttendanceSystem system;
+        cout.rdbuf(saved);
+        bench.run("loadStudents", n, n, nullptr, [&] { system.loadStudents(); });
+    }
+
+    // ----- Session creation (shared roster vs. a copy per session) -----
+    vector<AttendanceSession> created(config.sessions);
+    bench.run("session_create_shared", n, config.sessions, nullptr, [&] {
+        for (auto& s : created) s.initializeRecords(registry.roster());
+    });
+    bench.run("session_create_copied", n, config.sessions, nullptr, [&] {
+        for (auto& s : created) s.initializeRecords(roster);
+    });
+    bench.run("roster_register_one", n, 1, nullptr, [&] {
+        registry.roster()->append(roster[0].getIndexId());
+    });
+    bench.size("session_roster_memory", n, registry.roster()->memoryBytes(),
+               registry.roster()->memoryBytes() * config.sessions);
+
+    // ----- Session files -----
+    AttendanceSession session("EEE227", "2026-02-10", "09:00", 2);
+    session.initializeRecords(roster);
+    for (size_t i = 0; i < n; i++) session.updateRecord(roster[i].getIndex(), gen.status());
+
+    bench.run("session_saveToFile", n, n, nullptr, [&] { session.writeToFile(); });
+    bench.run("session_loadFromFile_text", n, n, nullptr, [&] {
+        AttendanceSession loaded;
+        loaded.loadFromFile(session.getFilename(), roster);
+    });
+
+    bench.run("session_saveToBinaryFile", n, n, nullptr, [&] {
+        session.saveToBinaryFile(session.getBinaryFilename());
+    });
+    bench.run("session_loadFromFile_binary", n, n, nullptr, [&] {
+        AttendanceSession loaded;
+        loaded.loadFromFile(session.getBinaryFilename(), roster);
+    });
+
+    // ----- Marking -----
+    vector<StatusUpdate> updates;
+    for (size_t i = 0; i < n; i++) {
+        updates.push_back(StatusUpdate{string(roster[gen.below(n)].getIndex()), gen.status()});
+    }
+    bench.run("updateRecord", n, n, nullptr, [&] {
+        for (const auto& update : updates) session.updateRecord(update.studentIndex, update.status);
+    });
+    bench.run("applyUpdates", n, n, nullptr, [&] { session.applyUpdates(updates); });
+
+    // ----- Snapshots -----
+    // A terminal's batch of marks, then publish: only the chunks the batch
+    // touched are copied
+    const size_t batch = 64;
+    bench.run("mark_batch_publish", n, batch, nullptr, [&] {
+        for (size_t i = 0; i < batch; i++) session.updateRecord(updates[i].studentIndex, updates[i].status);
+        session.publish();
+    });
+    {
+        // Marking in batches while another thread keeps reading snapshots;
+        // a snapshot that changed under its reader would count differently
+        atomic<bool> marking{true};
+        atomic<size_t> reads{0}, torn{0};
+        thread reader([&] {
+            while (marking.load()) {
+                SessionSnapshot::Ref snap = session.snapshot();
+                StatusCounts first = snap->countStatuses();
+                StatusCounts second = snap->countStatuses();
+                if (first != second) torn++;
+                reads++;
+            }
+        });
+        bench.run("mark_batches_with_reader", n, n, nullptr, [&] {
+            for (size_t i = 0; i < n; i += batch) {
+                for (size_t j = i; j < min(n, i + batch); j++) {
+                    session.updateRecord(updates[j].studentIndex, updates[j].status);
+                }
+                session.publish();
+            }
+        });
+        marking = false;
+        reader.join();
+        if (torn > 0) cerr << "snapshot readers saw " << torn << " changing snapshots" << endl;
+        bench.size("snapshot_publish_memory", n, session.snapshot()->memoryBytes(),
+                   session.getStatuses().memoryBytes());
+    }
+
+    // ----- Reports -----
+    bench.run("displayAttendance", n, n, nullptr, [&] { session.displayAttendance(registry); });
+
+    vector<AttendanceSession> sessions(config.sessions, session);
+    for (auto& s : sessions) {
+        for (size_t i = 0; i < n / 10; i++) s.updateRecord(roster[gen.below(n)].getIndex(), gen.status());
+    }
+    bench.run("displaySummary", n, config.sessions, nullptr, [&] {
+        for (const auto& s : sessions) s.displaySummary();
+    });
+    // ----- Term summary (50x the sessions above, over 10 courses) -----
+    {
+        vector<AttendanceSession> term;
+        term.reserve(config.sessions * 50);
+        for (size_t c = 0; c < 10; c++) {
+            char course[16];
+            snprintf(course, sizeof(course), "EEE%03zu", 220 + c);
+            AttendanceSession model(course, "2026-02-10", "09:00", 2);
+            model.initializeRecords(registry.roster());
+            vector<char> marks(n);
+            for (size_t j = 0; j < n; j++) marks[j] = sessions[c % sessions.size()].getStatus(j);
+            model.applyStatuses(marks);
+            for (size_t k = 0; k < config.sessions * 5; k++) term.push_back(model);
+        }
+        size_t records = term.size() * n;
+
+        bench.run("summary_serial", n, records, nullptr, [&] {
+            ReportWriter out;
+            for (const auto& s : term) s.displaySummary(out);
+        });
+        auto snapshots = [&term] {
+            vector<SessionSnapshot::Ref> versions;
+            versions.reserve(term.size());
+            for (auto& s : term) versions.push_back(s.current());
+            return versions;
+        };
+        ThreadPool pool;
+        bench.run("summary_engine", n, records, nullptr, [&] {
+            ReportWriter out;
+            SummaryReport report;
+            report.build(snapshots(), pool);
+            report.render(pool, out);
+        });
+        for (size_t threads = 2; threads < pool.concurrency(); threads *= 2) {
+            ThreadPool sized(threads - 1);
+            bench.run("summary_engine_t" + to_string(threads), n, records, nullptr, [&] {
+                ReportWriter out;
+                SummaryReport report;
+                report.build(snapshots(), sized);
+                report.render(sized, out);
+            });
+        }
+    }
+
+    // ----- Cross-session analytics -----
+    AttendanceAnalytics analytics;
+    bench.run("analytics_attach", n, config.sessions * n, [&] {
+        for (auto& s : sessions) s.attachAnalytics(nullptr);
+    }, [&] {
+        for (auto& s : sessions) s.attachAnalytics(&analytics);
+    });
+    const CourseAnalytics& course = analytics.course("EEE227");
+    bench.run("analytics_belowThreshold", n, n, nullptr, [&] { course.belowThreshold(75.0); });
+    bench.run("analytics_top10", n, n, nullptr, [&] { course.top(10); });
+    bench.run("updateRecord_with_analytics", n, n, nullptr, [&] {
+        for (const auto& update : updates) sessions[0].updateRecord(update.studentIndex, update.status);
+    });
+
+    bench.run("countStatuses", n, config.sessions * n, nullptr, [&] {
+        size_t total = 0;
+        for (const auto& s : sessions) total += s.countStatuses().total();
+        if (total != config.sessions * n) cerr << "countStatuses: bad total" << endl;
+    });
+
+    // ----- Session archive (the sessions above, one course) -----
+    vector<const AttendanceSession*> archived;
+    for (const auto& s : sessions) archived.push_back(&s);
+    string archiveFile = sessionArchiveFilename("EEE227");
+    string contents;
+    bench.run("archive_encode", n, config.sessions * n, nullptr, [&] {
+        contents = encodeSessionArchive("EEE227", archived);
+    });
+    writeFileAtomically(archiveFile, contents);
+    size_t textBytes = 0;
+    for (const auto& s : sessions) textBytes += s.toText().size();
+    bench.size("archive_size", n, contents.size(), textBytes);
+
+    bench.run("archive_scan", n, config.sessions * n, nullptr, [&] {
+        SessionArchiveReader reader;
+        reader.open(archiveFile);
+        size_t total = 0;
+        while (reader.next()) total += reader.getCounts().total();
+        if (total != config.sessions * n) cerr << "archive_scan: bad total" << endl;
+    });
+    vector<AttendanceSession> restored;
+    bench.run("archive_load", n, config.sessions * n, [&] { restored.clear(); }, [&] {
+        SessionArchiveReader reader;
+        reader.open(archiveFile);
+        while (reader.next()) restored.push_back(reader.toSession());
+    });
+    for (size_t i = 0; i < sessions.size(); i++) {
+        if (i >= restored.size() || restored[i].toText() != sessions[i].toText()) {
+            cerr << "archive_load: session " << i << " does not match" << endl;
+            break;
+        }
+    }
+
+    // ----- Session catalog (the sessions above on consecutive dates) -----
+    {
+        vector<string> files;
+        size_t bodyBytes = 0;
+        for (size_t i = 0; i < sessions.size(); i++) {
+            char date[32];
+            snprintf(date, sizeof(date), "2025-%02zu-%02zu", 1 + i / 28 % 12, 1 + i % 28);
+            AttendanceSession dated("EEE227", date, "09:00", 2);
+            dated.initializeRecords(sessions[i].getRoster());
+            vector<char> marks(n);
+            for (size_t j = 0; j < n; j++) marks[j] = sessions[i].getStatus(j);
+            dated.applyStatuses(marks);
+            dated.writeToFile();
+            files.push_back(dated.getFilename());
+            bodyBytes += dated.getStatuses().memoryBytes();
+        }
+
+        ThreadPool pool;
+        vector<string> errors;
+        SessionCatalog catalog;
+        bench.run("catalog_refresh_cold", n, files.size(), [&] { remove(catalog.getManifestFile().c_str()); }, [&] {
+            catalog.refresh(files, pool, errors);
+        });
+        bench.run("catalog_refresh_warm", n, files.size(), nullptr, [&] { catalog.refresh(files, pool, errors); });
+
+        // A budget of a quarter of the sessions, scanned in order: every load misses
+        size_t oneSession = sizeof(AttendanceSession) + bodyBytes / files.size();
+        catalog.setBudget(oneSession * max<size_t>(1, files.size() / 4));
+        string error;
+        bench.run("catalog_scan_budgeted", n, files.size() * n, nullptr, [&] {
+            for (size_t i = 0; i < catalog.size(); i++) catalog.load(i, roster, error);
+        });
+        size_t budgetedBytes = catalog.getResidentBytes();
+
+        catalog.setBudget(SessionCatalog::DEFAULT_BUDGET << 4);
+        for (size_t i = 0; i < catalog.size(); i++) catalog.load(i, roster, error);
+        bench.run("catalog_load_cached", n, files.size(), nullptr, [&] {
+            for (size_t i = 0; i < catalog.size(); i++) catalog.load(i, roster, error);
+        });
+        bench.size("catalog_resident", n, budgetedBytes, catalog.getResidentBytes());
+        if (!errors.empty() || !error.empty()) cerr << "catalog: could not read session files" << endl;
+    }
+
+    // ----- Check-in ingestion (4 sessions in a day, about 1.2 scans each) -----
+    {
+        static const char* starts[] = {"08:00", "10:00", "13:00", "15:00"};
+        vector<AttendanceSession> day;
+        for (const char* start : starts) {
+            day.push_back(AttendanceSession("EEE227", "2026-02-11", start, 2));
+            day.back().initializeRecords(registry.roster());
+        }
+        string scans;
+        size_t scanCount = 0;
+        for (size_t s = 0; s < day.size(); s++) {
+            int hour = 8 + (int)s * 2 + (s >= 2);
+            for (size_t i = 0; i < n; i++) {
+                char status = gen.status();
+                if (status == 'A') continue;
+                size_t repeats = gen.below(5) == 0 ? 2 : 1;
+                for (size_t r = 0; r < repeats; r++) {
+                    // Present: up to 20 minutes early or 10 late; Late: 11-59 minutes late
+                    int minute = status == 'P' ? 40 + (int)gen.below(31) : 71 + (int)gen.below(49);
+                    char line[64];
+                    string_view index = roster[i].getIndex();
+                    snprintf(line, sizeof(line), "%.*s,2026-02-11 %02d:%02d:%02zu\n", (int)index.size(),
+                             index.data(), hour - 1 + minute / 60, minute % 60, gen.below(60));
+                    scans += line;
+                    scanCount++;
+                }
+            }
+        }
+        writeFileAtomically("scans.csv", scans);
+
+        ThreadPool pool;
+        CheckInIngestor ingestor(day, pool);
+        CheckInStats stats;
+        bench.run("checkin_ingest", n, scanCount, nullptr, [&] { ingestor.ingestFile("scans.csv", stats); });
+        if (stats.scans != scanCount || stats.malformed + stats.noSession + stats.unknownStudent != 0) {
+            cerr << "checkin_ingest: " << stats.scans - stats.present - stats.late - stats.duplicates
+                 << " scans not applied" << endl;
+        }
+    }
+
+    // ----- Session index (headers only; n sessions over 20 courses) -----
+    vector<AttendanceSession> headers;
+    headers.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        char course[16], date[32];
+        snprintf(course, sizeof(course), "EEE%03zu", 200 + i % 20);
+        snprintf(date, sizeof(date), "%04zu-%02zu-%02zu", 2020 + i / 6000, 1 + i / 500 % 12, 1 + i / 20 % 25);
+        headers.push_back(AttendanceSession(course, date, "08:00", 2));
+    }
+    SessionIndex sessionIndex;
+    bench.run("sessionIndex_build", n, n, [&] { sessionIndex.clear(); }, [&] {
+        for (size_t i = 0; i < headers.size(); i++) sessionIndex.add(headers[i], i);
+    });
+    bench.run("sessionIndex_find", n, n, nullptr, [&] {
+        size_t found = 0;
+        for (const auto& h : headers) {
+            found += sessionIndex.find(h.getCourseCode(), h.getDate(), h.getStartTime()) != -1;
+        }
+        if (found != headers.size()) cerr << "sessionIndex_find: missing sessions" << endl;
+    });
+    bench.run("sessionIndex_courseMonth", n, 100, nullptr, [&] {
+        size_t total = 0;
+        for (size_t i = 0; i < 100; i++) {
+            total += sessionIndex.inCourse(headers[i * n / 100].getCourseCode(), "2020-02").size();
+        }
+        if (total > n * 100) cerr << "sessionIndex_courseMonth: bad total" << endl;
+    });
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        cerr << "Usage: benchmark [--scales=1000,10000,100000] [--sessions=20] "
+                "[--dist=70,20,10] [--seed=42] [--repeat=5] [--out=FILE]" << endl;
+        return 1;
+    }
+
+    ofstream outFile;
+    if (!config.outFile.empty()) {
+        outFile.open(config.outFile);
+        if (!outFile.is_open()) {
+            cerr << "Error: Could not open " << config.outFile << endl;
+            return 1;
+        }
+    }
+    ostream& out = config.outFile.empty() ? cout : outFile;
+
+    // Work in a scratch directory so the real data files are never touched
+    filesystem::path original = filesystem::current_path();
+    filesystem::path scratch = filesystem::temp_directory_path() /
+        ("attendance_bench_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    filesystem::create_directories(scratch);
+    filesystem::current_path(scratch);
+
+    out << "{\"op\":\"meta\",\"status_kernel\":\"" << PackedStatusVector::kernelName() << "\""
+        << ",\"threads\":" << thread::hardware_concurrency()
+#ifdef ATTENDANCE_NO_METRICS
+        << ",\"metrics\":false"
+#else
+        << ",\"metrics\":true"
+#endif
+        << ",\"seed\":" << config.seed
+        << ",\"dist\":\"" << config.presentPercent << "," << config.absentPercent
+        << "," << config.latePercent << "\"}" << endl;
+
+    BenchRunner bench(config, out);
+    for (size_t n : config.scales) {
+        benchScale(bench, config, n);
+    }
+
+    filesystem::current_path(original);
+    filesystem::remove_all(scratch);
+    return 0;
+}
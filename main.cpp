@@ -7,302 +7,5140 @@
 #include <sstream>
 #include <ctime>
 #include <limits>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <string_view>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_set>
+#include <unordered_map>
+#include <map>
+#include <list>
+#include <tuple>
+#include <memory>
+#include <charconv>
+#include <array>
+#include <shared_mutex>
+#include <csignal>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ATTENDANCE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
 
 using namespace std;
 
 // ==============================
-// 1. STUDENT CLASS
+// 1. REPORT WRITER
+// ==============================
+// Reports are formatted into one reusable buffer with to_chars and padded
+// fields instead of iostream manipulators, and handed to the stream in
+// large chunks. A writer goes to cout unless redirected to a file.
+class ReportWriter {
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    
+    string buffer;
+    ostream* out;
+    ofstream file;
+    
+    void reserveFor(size_t bytes) {
+        if (buffer.size() + bytes > BUFFER_SIZE) flushBuffer();
+    }
+    
+    void flushBuffer() {
+        out->write(buffer.data(), (streamsize)buffer.size());
+        buffer.clear();
+    }
+    
+public:
+    ReportWriter() : out(&cout) {
+        buffer.reserve(BUFFER_SIZE);
+    }
+    
+    // Write to another stream (e.g. a per-thread ostringstream)
+    explicit ReportWriter(ostream& target) : out(&target) {
+        buffer.reserve(BUFFER_SIZE);
+    }
+    
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+    
+    ~ReportWriter() { close(); }
+    
+    // Send everything written from now on to a file (truncated unless
+    // append is set); false if it cannot be opened, in which case the
+    // writer stays on cout
+    bool openFile(const string& filename, bool append = false) {
+        close();
+        file.open(filename, ios::out | ios::binary | (append ? ios::app : ios::trunc));
+        if (!file.is_open()) return false;
+        out = &file;
+        return true;
+    }
+    
+    bool isFile() const { return out == &file; }
+    
+    // Write out the buffer; a file target is closed and the writer returns to cout
+    void close() {
+        flush();
+        if (file.is_open()) file.close();
+        out = &cout;
+    }
+    
+    void flush() {
+        flushBuffer();
+        out->flush();
+    }
+    
+    ReportWriter& text(string_view str) {
+        if (str.size() > BUFFER_SIZE) {
+            flushBuffer();
+            out->write(str.data(), (streamsize)str.size());
+            return *this;
+        }
+        reserveFor(str.size());
+        buffer.append(str);
+        return *this;
+    }
+    
+    ReportWriter& put(char c) {
+        reserveFor(1);
+        buffer.push_back(c);
+        return *this;
+    }
+    
+    ReportWriter& repeat(char c, size_t count) {
+        while (count > 0) {
+            size_t chunk = min(count, BUFFER_SIZE);
+            reserveFor(chunk);
+            buffer.append(chunk, c);
+            count -= chunk;
+        }
+        return *this;
+    }
+    
+    ReportWriter& line() { return put('\n'); }
+    
+    // Left-aligned in a field of width columns; longer text is not cut
+    // (same as left << setw(width))
+    ReportWriter& field(string_view str, size_t width) {
+        text(str);
+        return str.size() < width ? repeat(' ', width - str.size()) : *this;
+    }
+    
+    ReportWriter& number(uint64_t value) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        return text(string_view(digits, (size_t)(result.ptr - digits)));
+    }
+    
+    ReportWriter& number(int64_t value) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        return text(string_view(digits, (size_t)(result.ptr - digits)));
+    }
+    
+    ReportWriter& number(int value) { return number((int64_t)value); }
+    
+    // Shortest text that reads back as value
+    ReportWriter& number(double value) {
+        char digits[32];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        if (result.ec != errc()) return text("?");
+        return text(string_view(digits, (size_t)(result.ptr - digits)));
+    }
+    
+    // Fixed-point with the given number of decimals (like fixed << setprecision)
+    ReportWriter& fixed(double value, int precision) {
+        char digits[64];
+        auto result = to_chars(digits, digits + sizeof(digits), value, chars_format::fixed, precision);
+        if (result.ec != errc()) return text("?");
+        return text(string_view(digits, (size_t)(result.ptr - digits)));
+    }
+    
+    ReportWriter& operator<<(string_view str) { return text(str); }
+    ReportWriter& operator<<(const char* str) { return text(str); }
+    ReportWriter& operator<<(const string& str) { return text(str); }
+    ReportWriter& operator<<(char c) { return put(c); }
+    ReportWriter& operator<<(size_t value) { return number((uint64_t)value); }
+    ReportWriter& operator<<(int value) { return number(value); }
+};
+
+// ==============================
+// 2. METRICS
+// ==============================
+// Built-in instrumentation: every operation below has a latency histogram
+// (nanoseconds, log-linear buckets in the style of HdrHistogram: 16 linear
+// sub-buckets per power of two, so quantiles are within 1/16) plus byte and
+// record counters for file I/O. Recording is a handful of relaxed atomic
+// adds, safe from any thread; single-record marking is timed on a 1-in-64
+// sample. Build with -DATTENDANCE_NO_METRICS to compile
+// the timers and counters out entirely.
+
+enum class Metric {
+    LoadStudents,
+    SaveStudents,
+    JournalAppend,
+    LoadSessionText,
+    LoadSessionBinary,
+    SaveSessionText,
+    SaveSessionBinary,
+    MarkRecord,
+    ApplyUpdates,
+    ApplyStatuses,
+    ReportAttendance,
+    ReportSummary,
+    ReportSummaryAll,
+    ArchiveWrite,
+    ArchiveOpen,
+    IngestCheckIns,
+    CatalogLoad,
+    PublishSnapshot,
+    AutosaveFlush,
+    COUNT
+};
+
+inline const char* metricName(Metric metric) {
+    static const char* names[(size_t)Metric::COUNT] = {
+        "load_students", "save_students", "journal_append",
+        "load_session_text", "load_session_binary", "save_session_text", "save_session_binary",
+        "mark_record", "apply_updates", "apply_statuses",
+        "report_attendance", "report_summary", "report_summary_all",
+        "archive_write", "archive_open", "ingest_checkins", "catalog_load",
+        "publish_snapshot", "autosave_flush",
+    };
+    return names[(size_t)metric];
+}
+
+#ifndef ATTENDANCE_NO_METRICS
+
+class LatencyHistogram {
+private:
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+    
+    array<atomic<uint64_t>, BUCKETS> buckets{};
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> sum{0};
+    atomic<uint64_t> maximum{0};
+    
+    static unsigned highestBit(uint64_t value) {
+#if defined(__GNUC__)
+        return 63 - (unsigned)__builtin_clzll(value);
+#else
+        unsigned bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+#endif
+    }
+    
+    // Values below 16 get a bucket each; above that, 16 buckets per octave
+    static size_t bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) return (size_t)value;
+        unsigned shift = highestBit(value) - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+    }
+    
+    // Largest value that falls in a bucket
+    static uint64_t bucketLimit(size_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        unsigned shift = (unsigned)(bucket / SUB_BUCKETS - 1);
+        uint64_t lower = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+    
+public:
+    // Add a measurement; weight > 1 stands for that many similar calls
+    void record(uint64_t nanos, uint64_t weight = 1) {
+        buckets[bucketOf(nanos)].fetch_add(weight, memory_order_relaxed);
+        total.fetch_add(weight, memory_order_relaxed);
+        sum.fetch_add(nanos * weight, memory_order_relaxed);
+        uint64_t seen = maximum.load(memory_order_relaxed);
+        while (nanos > seen && !maximum.compare_exchange_weak(seen, nanos, memory_order_relaxed)) {}
+    }
+    
+    uint64_t count() const { return total.load(memory_order_relaxed); }
+    uint64_t sumNanos() const { return sum.load(memory_order_relaxed); }
+    uint64_t maxNanos() const { return maximum.load(memory_order_relaxed); }
+    
+    // Upper bound of the bucket holding the q-quantile (0 if empty)
+    uint64_t quantile(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = (uint64_t)(q * (double)(n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < BUCKETS; b++) {
+            seen += buckets[b].load(memory_order_relaxed);
+            if (seen >= rank) return min(bucketLimit(b), maxNanos());
+        }
+        return maxNanos();
+    }
+};
+
+class MetricsRegistry {
+private:
+    static constexpr size_t COUNT = (size_t)Metric::COUNT;
+    
+    LatencyHistogram latency[COUNT];
+    atomic<uint64_t> bytes[COUNT] = {};
+    atomic<uint64_t> records[COUNT] = {};
+    
+public:
+    static MetricsRegistry& global() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+    
+    void recordLatency(Metric metric, uint64_t nanos, uint64_t weight = 1) {
+        latency[(size_t)metric].record(nanos, weight);
+    }
+    
+    void recordIo(Metric metric, uint64_t byteCount, uint64_t recordCount) {
+        bytes[(size_t)metric].fetch_add(byteCount, memory_order_relaxed);
+        records[(size_t)metric].fetch_add(recordCount, memory_order_relaxed);
+    }
+    
+    // Prometheus text exposition format
+    string prometheusText() const {
+        static const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+        static const char* quantileLabels[] = {"0.5", "0.9", "0.99", "0.999"};
+        string text;
+        char number[64];
+        auto seconds = [&number](uint64_t nanos) {
+            auto result = to_chars(number, number + sizeof(number), (double)nanos / 1e9);
+            return string_view(number, (size_t)(result.ptr - number));
+        };
+        
+        text += "# HELP attendance_operation_duration_seconds Time spent in each operation.\n";
+        text += "# TYPE attendance_operation_duration_seconds summary\n";
+        for (size_t m = 0; m < COUNT; m++) {
+            string label = string("op=\"") + metricName((Metric)m) + "\"";
+            for (int q = 0; q < 4; q++) {
+                text += "attendance_operation_duration_seconds{" + label + ",quantile=\"";
+                text += quantileLabels[q];
+                text += "\"} ";
+                text += seconds(latency[m].quantile(quantiles[q]));
+                text += '\n';
+            }
+            text += "attendance_operation_duration_seconds_sum{" + label + "} ";
+            text += seconds(latency[m].sumNanos());
+            text += "\nattendance_operation_duration_seconds_count{" + label + "} ";
+            text += to_string(latency[m].count()) + "\n";
+        }
+        
+        const char* counters[2][2] = {
+            {"attendance_io_bytes_total", "Bytes read or written by each operation."},
+            {"attendance_io_records_total", "Records read or written by each operation."},
+        };
+        for (int c = 0; c < 2; c++) {
+            text += string("# HELP ") + counters[c][0] + " " + counters[c][1] + "\n";
+            text += string("# TYPE ") + counters[c][0] + " counter\n";
+            for (size_t m = 0; m < COUNT; m++) {
+                const atomic<uint64_t>& value = c == 0 ? bytes[m] : records[m];
+                text += string(counters[c][0]) + "{op=\"" + metricName((Metric)m) + "\"} " +
+                        to_string(value.load(memory_order_relaxed)) + "\n";
+            }
+        }
+        return text;
+    }
+    
+    // Table of the operations that have run, latencies in microseconds
+    void dump(ReportWriter& out) const {
+        out << "\nPERFORMANCE METRICS (latencies in microseconds):\n";
+        out.field("Operation", 22).field("Count", 10).field("p50", 10).field("p99", 10)
+           .field("Max", 12).field("Bytes", 14).field("Records", 10).line();
+        out.repeat('-', 88).line();
+        
+        bool any = false;
+        for (size_t m = 0; m < COUNT; m++) {
+            const LatencyHistogram& h = latency[m];
+            if (h.count() == 0) continue;
+            any = true;
+            out.field(metricName((Metric)m), 22).field(to_string(h.count()), 10);
+            uint64_t values[3] = {h.quantile(0.5), h.quantile(0.99), h.maxNanos()};
+            size_t widths[3] = {10, 10, 12};
+            for (int i = 0; i < 3; i++) {
+                char number[32];
+                auto result = to_chars(number, number + sizeof(number), (double)values[i] / 1000.0,
+                                       chars_format::fixed, 1);
+                out.field(string_view(number, (size_t)(result.ptr - number)), widths[i]);
+            }
+            out.field(to_string(bytes[m].load(memory_order_relaxed)), 14)
+               .field(to_string(records[m].load(memory_order_relaxed)), 10).line();
+        }
+        if (!any) out << "No operations recorded yet.\n";
+    }
+};
+
+// Records the lifetime of a scope into a metric's histogram
+class ScopedMetricTimer {
+private:
+    Metric metric;
+    chrono::steady_clock::time_point started;
+    
+public:
+    explicit ScopedMetricTimer(Metric m) : metric(m), started(chrono::steady_clock::now()) {}
+    
+    ScopedMetricTimer(const ScopedMetricTimer&) = delete;
+    ScopedMetricTimer& operator=(const ScopedMetricTimer&) = delete;
+    
+    ~ScopedMetricTimer() {
+        auto elapsed = chrono::steady_clock::now() - started;
+        MetricsRegistry::global().recordLatency(
+            metric, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+// Times one in every SAMPLE_INTERVAL passes through a scope (counted per
+// thread) and records it with that weight. For per-record paths, where
+// reading the clock twice would cost more than the work being measured.
+class SampledMetricTimer {
+private:
+    static constexpr uint32_t SAMPLE_INTERVAL = 64;
+    
+    Metric metric;
+    bool active;
+    chrono::steady_clock::time_point started;
+    
+    static bool due(Metric m) {
+        static thread_local uint32_t countdown[(size_t)Metric::COUNT] = {};
+        uint32_t& left = countdown[(size_t)m];
+        if (left != 0) {
+            left--;
+            return false;
+        }
+        left = SAMPLE_INTERVAL - 1;
+        return true;
+    }
+    
+public:
+    explicit SampledMetricTimer(Metric m) : metric(m), active(due(m)) {
+        if (active) started = chrono::steady_clock::now();
+    }
+    
+    SampledMetricTimer(const SampledMetricTimer&) = delete;
+    SampledMetricTimer& operator=(const SampledMetricTimer&) = delete;
+    
+    ~SampledMetricTimer() {
+        if (!active) return;
+        auto elapsed = chrono::steady_clock::now() - started;
+        MetricsRegistry::global().recordLatency(
+            metric, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(elapsed).count(), SAMPLE_INTERVAL);
+    }
+};
+
+#define METRIC_TIMER(metric) ScopedMetricTimer metricTimer_(metric)
+#define METRIC_SAMPLED_TIMER(metric) SampledMetricTimer metricTimer_(metric)
+#define METRIC_IO(metric, byteCount, recordCount) \
+    MetricsRegistry::global().recordIo(metric, byteCount, recordCount)
+
+inline string metricsPrometheusText() { return MetricsRegistry::global().prometheusText(); }
+inline void dumpMetrics(ReportWriter& out) { MetricsRegistry::global().dump(out); }
+
+#else
+
+#define METRIC_TIMER(metric) ((void)0)
+#define METRIC_SAMPLED_TIMER(metric) ((void)0)
+#define METRIC_IO(metric, byteCount, recordCount) ((void)0)
+
+inline string metricsPrometheusText() { return "# metrics disabled in this build\n"; }
+inline void dumpMetrics(ReportWriter& out) { out << "\nMetrics are disabled in this build.\n"; }
+
+#endif
+
+// ==============================
+// 3. INDEX HASH TABLE
+// ==============================
+// Open-addressing (linear probing) hash index from index numbers to
+// positions in an array owned by the caller. Keys are not stored here; the
+// owner passes a keyAt(pos) accessor so a probe can confirm a match.
+class IndexHashTable {
+private:
+    struct Slot {
+        uint32_t hash; // low bits of the key hash, also picks the home bucket
+        int32_t pos;   // position in the owner's array, -1 = empty
+    };
+    
+    vector<Slot> slots;
+    size_t slotMask = 0;
+    size_t count = 0;
+    
+    void grow() {
+        vector<Slot> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, Slot{0, -1});
+        slotMask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.pos == -1) continue;
+            size_t i = slot.hash & slotMask;
+            while (slots[i].pos != -1) {
+                i = (i + 1) & slotMask;
+            }
+            slots[i] = slot;
+        }
+    }
+    
+    // Find the slot holding key, or the empty slot where it would go
+    template <typename KeyAt>
+    size_t probe(string_view key, uint32_t h, KeyAt keyAt) const {
+        size_t i = h & slotMask;
+        while (slots[i].pos != -1) {
+            if (slots[i].hash == h && keyAt(slots[i].pos) == key) {
+                break;
+            }
+            i = (i + 1) & slotMask;
+        }
+        return i;
+    }
+    
+public:
+    IndexHashTable() {
+        clear();
+    }
+    
+    static uint32_t hashKey(string_view key) {
+        // FNV-1a, folded to 32 bits
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return (uint32_t)(h ^ (h >> 32));
+    }
+    
+    size_t size() const { return count; }
+    
+    // Drop all entries, pre-sizing for an expected number of keys
+    void clear(size_t expected = 0) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity *= 2;
+        slots.assign(capacity, Slot{0, -1});
+        slotMask = capacity - 1;
+        count = 0;
+    }
+    
+    // Grow ahead of a bulk insert so it never rehashes midway
+    void reserve(size_t expected) {
+        while (slots.size() < expected * 2) grow();
+    }
+    
+    // Position stored for key, or -1
+    template <typename KeyAt>
+    int find(string_view key, KeyAt keyAt) const {
+        return slots[probe(key, hashKey(key), keyAt)].pos;
+    }
+    
+    // Map key to pos; returns false (leaving the table unchanged) if key exists
+    template <typename KeyAt>
+    bool insert(string_view key, int pos, KeyAt keyAt) {
+        uint32_t h = hashKey(key);
+        size_t i = probe(key, h, keyAt);
+        if (slots[i].pos != -1) return false;
+        
+        slots[i] = Slot{h, (int32_t)pos};
+        count++;
+        
+        // Keep the load factor at or below 1/2
+        if (count * 2 > slots.size()) grow();
+        return true;
+    }
+};
+
+// ==============================
+// 4. STRING INTERNER
+// ==============================
+// One shared arena for index numbers and names. Each distinct string is
+// stored once and named by a 32-bit id, so students, session records and
+// analytics carry ids instead of their own copies. Stored strings never
+// move or get freed, so a view from operator[] stays valid for the life of
+// the program. Interning takes a lock; reading an id's text does not.
+class StringInterner {
+private:
+    static constexpr size_t BLOCK_BITS = 16;
+    static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+    static constexpr size_t MAX_BLOCKS = 4096;
+    static constexpr size_t CHUNK_BYTES = 1 << 20;
+    
+    // id -> text, in fixed blocks so existing entries never move
+    unique_ptr<unique_ptr<string_view[]>[]> blocks;
+    atomic<uint32_t> count{0};
+    
+    // Character storage, appended to in chunks
+    vector<unique_ptr<char[]>> chunks;
+    char* chunkNext = nullptr;
+    size_t chunkLeft = 0;
+    
+    IndexHashTable byText;
+    mutable shared_mutex lock;
+    
+    string_view keyAt(int id) const { return (*this)[(uint32_t)id]; }
+    
+    string_view store(string_view str) {
+        if (str.empty()) return string_view();
+        if (str.size() > chunkLeft) {
+            size_t bytes = max(CHUNK_BYTES, str.size());
+            chunks.push_back(unique_ptr<char[]>(new char[bytes]));
+            chunkNext = chunks.back().get();
+            chunkLeft = bytes;
+        }
+        memcpy(chunkNext, str.data(), str.size());
+        string_view stored(chunkNext, str.size());
+        chunkNext += str.size();
+        chunkLeft -= str.size();
+        return stored;
+    }
+    
+    // Add str, or return its existing id; call with the lock held
+    // exclusively. Throws length_error when every id is taken.
+    uint32_t addLocked(string_view str) {
+        auto key = [this](int p) { return keyAt(p); };
+        int existing = byText.find(str, key);
+        if (existing != -1) return (uint32_t)existing;
+        
+        uint32_t id = count.load(memory_order_relaxed);
+        size_t block = id >> BLOCK_BITS;
+        if (block >= MAX_BLOCKS) {
+            // Out of ids (268M distinct strings). Handing out an existing id
+            // would silently merge this string with another one.
+            throw length_error("string interner is out of ids (" + to_string(id) + " strings)");
+        }
+        if (!blocks[block]) blocks[block].reset(new string_view[BLOCK_SIZE]);
+        blocks[block][id & (BLOCK_SIZE - 1)] = store(str);
+        count.store(id + 1, memory_order_release);
+        byText.insert(str, (int)id, key);
+        return id;
+    }
+    
+public:
+    StringInterner() : blocks(new unique_ptr<string_view[]>[MAX_BLOCKS]) {
+        addLocked(""); // id 0 is the empty string
+    }
+    
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    
+    // The arena shared by the registry and every session
+    static StringInterner& shared() {
+        static StringInterner instance;
+        return instance;
+    }
+    
+    size_t size() const { return count.load(memory_order_acquire); }
+    
+    string_view operator[](uint32_t id) const {
+        return blocks[id >> BLOCK_BITS][id & (BLOCK_SIZE - 1)];
+    }
+    
+    // Id of str if it has been interned, otherwise NOT_FOUND
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+    uint32_t find(string_view str) const {
+        shared_lock<shared_mutex> guard(lock);
+        int id = byText.find(str, [this](int p) { return keyAt(p); });
+        return id == -1 ? NOT_FOUND : (uint32_t)id;
+    }
+    
+    uint32_t intern(string_view str) {
+        uint32_t id = find(str);
+        if (id != NOT_FOUND) return id;
+        unique_lock<shared_mutex> guard(lock);
+        return addLocked(str);
+    }
+    
+    // Intern a batch under one lock (e.g. every record of a session file)
+    void internAll(const vector<string_view>& strs, vector<uint32_t>& ids) {
+        ids.resize(strs.size());
+        unique_lock<shared_mutex> guard(lock);
+        byText.reserve(count.load(memory_order_relaxed) + strs.size());
+        for (size_t i = 0; i < strs.size(); i++) {
+            ids[i] = addLocked(strs[i]);
+        }
+    }
+};
+
+// ==============================
+// 5. STUDENT CLASS
 // ==============================
+// Index number and name are ids into the shared StringInterner
 class Student {
 private:
-    string indexNumber;
-    string name;
+    uint32_t indexId;
+    uint32_t nameId;
     
 public:
-    Student() : indexNumber(""), name("") {}
+    Student() : indexId(0), nameId(0) {}
     
-    Student(string idx, string n) : indexNumber(idx), name(n) {}
+    Student(string_view idx, string_view n)
+        : indexId(StringInterner::shared().intern(idx)), nameId(StringInterner::shared().intern(n)) {}
     
     // Getters
-    string getIndex() const { return indexNumber; }
-    string getName() const { return name; }
+    string_view getIndex() const { return StringInterner::shared()[indexId]; }
+    string_view getName() const { return StringInterner::shared()[nameId]; }
+    uint32_t getIndexId() const { return indexId; }
+    uint32_t getNameId() const { return nameId; }
     
     // Setters
-    void setIndex(string idx) { indexNumber = idx; }
-    void setName(string n) { name = n; }
+    void setIndex(string_view idx) { indexId = StringInterner::shared().intern(idx); }
+    void setName(string_view n) { nameId = StringInterner::shared().intern(n); }
     
     // Display student info
-    void display() const {
-        cout << left << setw(15) << indexNumber 
-             << setw(25) << name << endl;
+    void display(ReportWriter& out) const {
+        out.field(getIndex(), 15).field(getName(), 25).line();
     }
     
     // Convert to string for file storage
     string toString() const {
-        return indexNumber + "," + name;
+        string text(getIndex());
+        text += ',';
+        text += getName();
+        return text;
     }
     
     // Load from string (for file reading)
     static Student fromString(const string& data) {
         size_t commaPos = data.find(',');
         if (commaPos != string::npos) {
-            string idx = data.substr(0, commaPos);
-            string name = data.substr(commaPos + 1);
-            return Student(idx, name);
+            string_view line(data);
+            return Student(line.substr(0, commaPos), line.substr(commaPos + 1));
         }
         return Student("", "");
     }
-};
+};
+
+// ==============================
+// 6. ROSTER
+// ==============================
+// An immutable list of student ids (interned index numbers) that sessions
+// share by reference. Ids are kept in fixed-size chunks held by shared_ptr,
+// so appending builds a new version that shares every full chunk with the
+// old one and copies only the chunk table and the last, partly filled
+// chunk. Creating a session from the registry takes a reference to the
+// current version in O(1), so memory grows with roster changes rather than
+// with the number of sessions. The index-number lookup table used for
+// marking is built on first use and shared by every session of a version.
+class Roster {
+public:
+    using Ref = shared_ptr<const Roster>;
+    
+private:
+    static constexpr size_t CHUNK_BITS = 10;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    
+    struct Chunk {
+        uint32_t ids[CHUNK_SIZE];
+    };
+    
+    vector<shared_ptr<const Chunk>> chunks;
+    size_t count = 0;
+    
+    mutable once_flag lookupBuilt;
+    mutable IndexHashTable lookup;
+    
+    Roster() = default;
+    
+    // New version with ids appended; full chunks are shared with this one
+    Ref extended(const uint32_t* ids, size_t n) const {
+        shared_ptr<Roster> next(new Roster);
+        next->chunks = chunks;
+        next->count = count;
+        size_t used = count & (CHUNK_SIZE - 1);
+        shared_ptr<Chunk> tail;
+        if (used != 0) {
+            // The partly filled last chunk may be shared, so copy it
+            tail = make_shared<Chunk>(*next->chunks.back());
+            next->chunks.back() = tail;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (used == 0) {
+                tail = make_shared<Chunk>();
+                next->chunks.push_back(tail);
+            }
+            tail->ids[used] = ids[i];
+            used = (used + 1) & (CHUNK_SIZE - 1);
+        }
+        next->count += n;
+        return next;
+    }
+    
+public:
+    Roster(const Roster&) = delete;
+    Roster& operator=(const Roster&) = delete;
+    
+    static Ref empty() {
+        static const Ref instance(new Roster);
+        return instance;
+    }
+    
+    static Ref fromIds(const vector<uint32_t>& ids) {
+        return empty()->extended(ids.data(), ids.size());
+    }
+    
+    Ref append(uint32_t id) const { return extended(&id, 1); }
+    Ref appendAll(const vector<uint32_t>& ids) const { return extended(ids.data(), ids.size()); }
+    
+    size_t size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    
+    uint32_t operator[](size_t i) const {
+        return chunks[i >> CHUNK_BITS]->ids[i & (CHUNK_SIZE - 1)];
+    }
+    
+    string_view indexAt(size_t i) const { return StringInterner::shared()[(*this)[i]]; }
+    
+    // Position of the first entry with this index number, or -1. Safe to
+    // call from several threads; the first call builds the table.
+    int find(string_view studentIndex) const {
+        auto key = [this](int p) { return indexAt((size_t)p); };
+        call_once(lookupBuilt, [this, &key] {
+            lookup.clear(count);
+            for (size_t i = 0; i < count; i++) {
+                // On duplicate indexes the first entry wins, as with a linear scan
+                lookup.insert(indexAt(i), (int)i, key);
+            }
+        });
+        return lookup.find(studentIndex, key);
+    }
+    
+    // True if this roster's ids are the first size() ids of other
+    bool isPrefixOf(const Roster& other) const {
+        if (count > other.count) return false;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            if (chunks[c] == other.chunks[c]) continue;
+            size_t n = min(CHUNK_SIZE, count - c * CHUNK_SIZE);
+            if (memcmp(chunks[c]->ids, other.chunks[c]->ids, n * sizeof(uint32_t)) != 0) return false;
+        }
+        return true;
+    }
+    
+    bool sameAs(const Roster& other) const {
+        return count == other.count && isPrefixOf(other);
+    }
+    
+    // Bytes held by this version alone if none of its chunks were shared
+    size_t memoryBytes() const {
+        return sizeof(Roster) + chunks.size() * (sizeof(Chunk) + sizeof(shared_ptr<const Chunk>));
+    }
+};
+
+// ==============================
+// 7. NAME SEARCH INDEX
+// ==============================
+// Fuzzy lookup by trigrams: each document (a name or an index number) is
+// lowercased, other characters become word breaks, and every run of three
+// characters is posted to an inverted list. A query is broken up the same
+// way; documents are ranked by how many of the query's trigrams they
+// contain, so partial and misspelled queries ("kwame mens", "Kwame Mesnah")
+// still rank the right student near the top. Candidates are drawn from the
+// query's rarest trigrams only, so common ones ("  k") are never scanned.
+class TrigramIndex {
+public:
+    struct Match {
+        uint32_t document;
+        uint16_t shared; // query trigrams found in the document
+        uint16_t grams;  // distinct trigrams of the document
+    };
+    
+    // More shared trigrams first, then shorter documents, then earlier ones
+    static bool ranksBefore(const Match& a, const Match& b) {
+        if (a.shared != b.shared) return a.shared > b.shared;
+        if (a.grams != b.grams) return a.grams < b.grams;
+        return a.document < b.document;
+    }
+    
+    // Distinct trigrams of text, sorted. Every word starts after two spaces
+    // so its first letters weigh in; the end is padded only if padEnd, so a
+    // query that stops mid-word ("mens") still matches in full.
+    static void trigrams(string_view text, vector<uint32_t>& grams, bool padEnd = true) {
+        string normalized = "  ";
+        for (char c : text) {
+            unsigned char u = (unsigned char)c;
+            if (isalnum(u)) {
+                normalized += (char)tolower(u);
+            } else if (normalized.back() != ' ') {
+                normalized += "  ";
+            }
+        }
+        if (padEnd && normalized.back() != ' ') normalized += ' ';
+        
+        grams.clear();
+        for (size_t i = 0; i + 3 <= normalized.size(); i++) {
+            grams.push_back((uint32_t)(unsigned char)normalized[i] << 16 |
+                            (uint32_t)(unsigned char)normalized[i + 1] << 8 |
+                            (uint32_t)(unsigned char)normalized[i + 2]);
+        }
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+    }
+    
+private:
+    unordered_map<uint32_t, vector<uint32_t>> postings; // trigram -> documents, ascending
+    vector<uint16_t> gramCounts;                        // per document
+    vector<uint32_t> scratch;
+    
+public:
+    size_t size() const { return gramCounts.size(); }
+    
+    void clear() {
+        postings.clear();
+        gramCounts.clear();
+    }
+    
+    // Index the next document (its number is the current size())
+    void add(string_view text) {
+        uint32_t document = (uint32_t)gramCounts.size();
+        trigrams(text, scratch);
+        for (uint32_t gram : scratch) {
+            postings[gram].push_back(document);
+        }
+        gramCounts.push_back((uint16_t)min<size_t>(scratch.size(), UINT16_MAX));
+    }
+    
+    // The best limit documents for query (plus any tied with the last on
+    // shared and grams), among those containing at least minShare of its
+    // trigrams; queryGrams receives the query's trigram count
+    vector<Match> search(string_view query, size_t limit, double minShare = 0.5,
+                         size_t* queryGrams = nullptr) const {
+        static const vector<uint32_t> none;
+        vector<uint32_t> grams;
+        trigrams(query, grams, false);
+        if (queryGrams) *queryGrams = grams.size();
+        vector<Match> result;
+        if (grams.empty() || limit == 0) return result;
+        size_t needed = max<size_t>(1, (size_t)ceil(minShare * grams.size()));
+        
+        // A document with needed of the trigrams is on at least one of the
+        // grams.size() - needed + 1 shortest lists
+        vector<const vector<uint32_t>*> lists;
+        for (uint32_t gram : grams) {
+            auto it = postings.find(gram);
+            lists.push_back(it == postings.end() ? &none : &it->second);
+        }
+        sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+            return a->size() < b->size();
+        });
+        size_t prefix = grams.size() - needed + 1;
+        
+        // Candidates and their counts are kept sparse, sorted by document:
+        // the work is proportional to the lists read, not the document count
+        vector<uint32_t> drawn;
+        for (size_t i = 0; i < prefix; i++) {
+            drawn.insert(drawn.end(), lists[i]->begin(), lists[i]->end());
+        }
+        sort(drawn.begin(), drawn.end());
+        vector<uint32_t> candidates;
+        vector<uint16_t> counts;
+        for (size_t i = 0; i < drawn.size();) {
+            size_t j = i;
+            while (j < drawn.size() && drawn[j] == drawn[i]) j++;
+            candidates.push_back(drawn[i]);
+            counts.push_back((uint16_t)(j - i));
+            i = j;
+        }
+        
+        // The longer lists only add to candidates: probed one candidate at a
+        // time while there are few, merged against them once there are many
+        for (size_t i = prefix; i < lists.size(); i++) {
+            const vector<uint32_t>& list = *lists[i];
+            if (candidates.size() * 16 < list.size()) {
+                for (size_t c = 0; c < candidates.size(); c++) {
+                    if (binary_search(list.begin(), list.end(), candidates[c])) counts[c]++;
+                }
+            } else {
+                size_t c = 0;
+                for (uint32_t document : list) {
+                    while (c < candidates.size() && candidates[c] < document) c++;
+                    if (c == candidates.size()) break;
+                    if (candidates[c] == document) counts[c]++;
+                }
+            }
+        }
+        for (size_t c = 0; c < candidates.size(); c++) {
+            result.push_back(Match{candidates[c], counts[c], gramCounts[candidates[c]]});
+        }
+        result.erase(remove_if(result.begin(), result.end(),
+                               [needed](const Match& m) { return m.shared < needed; }),
+                     result.end());
+        
+        if (result.size() <= limit) {
+            sort(result.begin(), result.end(), ranksBefore);
+            return result;
+        }
+        partial_sort(result.begin(), result.begin() + limit, result.end(), ranksBefore);
+        Match last = result[limit - 1];
+        auto tiedEnd = partition(result.begin() + limit, result.end(), [&last](const Match& m) {
+            return m.shared == last.shared && m.grams == last.grams;
+        });
+        sort(result.begin() + limit, tiedEnd, ranksBefore);
+        result.erase(tiedEnd, result.end());
+        return result;
+    }
+};
+
+// ==============================
+// 8. STUDENT REGISTRY CLASS
+// ==============================
+// Keeps students in insertion order (for display) and indexes them three
+// ways: an IndexHashTable on indexNumber for O(1) duplicate checks and
+// lookups, a lazily sorted order for prefix/range queries like "EE20", and
+// a lazily extended trigram index for fuzzy name search. The
+// current Roster version (what new sessions are created from) is also
+// brought up to date lazily, so a bulk import makes one new version.
+class StudentRegistry {
+private:
+    vector<Student> students;
+    IndexHashTable byIndex;
+    
+    // Positions ordered by index number; entries past sortedCount are unsorted
+    mutable vector<int32_t> sortedOrder;
+    mutable size_t sortedCount = 0;
+    
+    // Roster of the first currentRoster->size() students
+    mutable Roster::Ref currentRoster = Roster::empty();
+    
+    // Fuzzy search over the first searchIndexed students: each distinct
+    // name is one document, each index number another
+    mutable TrigramIndex nameIndex;
+    mutable vector<vector<int32_t>> documentStudents; // document -> positions
+    mutable unordered_map<uint32_t, uint32_t> nameDocuments; // name id -> document
+    mutable size_t searchIndexed = 0;
+    
+    void syncNameIndex() const {
+        for (; searchIndexed < students.size(); searchIndexed++) {
+            const Student& student = students[searchIndexed];
+            auto [it, added] = nameDocuments.emplace(student.getNameId(), (uint32_t)nameIndex.size());
+            if (added) {
+                nameIndex.add(student.getName());
+                documentStudents.emplace_back();
+            }
+            documentStudents[it->second].push_back((int32_t)searchIndexed);
+            
+            nameIndex.add(student.getIndex());
+            documentStudents.push_back({(int32_t)searchIndexed});
+        }
+    }
+    
+    string_view keyAt(int pos) const { return students[pos].getIndex(); }
+    
+    // Bring the sorted secondary index up to date with any new students
+    void syncSortedOrder() const {
+        if (sortedCount == sortedOrder.size()) return;
+        
+        auto indexLess = [this](int32_t a, int32_t b) {
+            return students[a].getIndex() < students[b].getIndex();
+        };
+        auto middle = sortedOrder.begin() + sortedCount;
+        sort(middle, sortedOrder.end(), indexLess);
+        inplace_merge(sortedOrder.begin(), middle, sortedOrder.end(), indexLess);
+        sortedCount = sortedOrder.size();
+    }
+    
+public:
+    size_t size() const { return students.size(); }
+    bool empty() const { return students.empty(); }
+    const Student& operator[](size_t pos) const { return students[pos]; }
+    const vector<Student>& all() const { return students; }
+    vector<Student>::const_iterator begin() const { return students.begin(); }
+    vector<Student>::const_iterator end() const { return students.end(); }
+    
+    void clear() {
+        students.clear();
+        sortedOrder.clear();
+        sortedCount = 0;
+        byIndex.clear();
+        currentRoster = Roster::empty();
+        nameIndex.clear();
+        documentStudents.clear();
+        nameDocuments.clear();
+        searchIndexed = 0;
+    }
+    
+    // The roster of every registered student, as a shared immutable version
+    const Roster::Ref& roster() const {
+        size_t have = currentRoster->size();
+        if (have < students.size()) {
+            vector<uint32_t> ids;
+            ids.reserve(students.size() - have);
+            for (size_t i = have; i < students.size(); i++) {
+                ids.push_back(students[i].getIndexId());
+            }
+            currentRoster = currentRoster->appendAll(ids);
+        }
+        return currentRoster;
+    }
+    
+    // Pre-size the hash index for an expected number of students
+    void reserve(size_t count) {
+        students.reserve(count);
+        sortedOrder.reserve(count);
+        byIndex.reserve(count);
+    }
+    
+    // Add a student; returns false if the index number is already registered
+    bool add(const Student& student) {
+        int pos = (int)students.size();
+        auto key = [this, &student, pos](int p) {
+            return p == pos ? student.getIndex() : keyAt(p);
+        };
+        if (!byIndex.insert(student.getIndex(), pos, key)) return false;
+        
+        students.push_back(student);
+        sortedOrder.push_back(pos);
+        return true;
+    }
+    
+    // Position of a student in insertion order, or -1 if not registered
+    int find(string_view idx) const {
+        return byIndex.find(idx, [this](int p) { return keyAt(p); });
+    }
+    
+    bool contains(string_view idx) const { return find(idx) != -1; }
+    
+    // Lookup by index number; nullptr if not registered
+    const Student* get(string_view idx) const {
+        int pos = find(idx);
+        return pos == -1 ? nullptr : &students[pos];
+    }
+    
+    // Students whose name or index number resembles query (partial or
+    // misspelled), best match first, with the share of the query matched.
+    // Students of equally ranked documents come in registration order.
+    vector<pair<const Student*, double>> searchByName(string_view query, size_t limit) const {
+        syncNameIndex();
+        size_t queryGrams = 0;
+        vector<TrigramIndex::Match> matches = nameIndex.search(query, limit, 0.5, &queryGrams);
+        
+        vector<pair<const Student*, double>> result;
+        unordered_set<int32_t> seen;
+        vector<int32_t> group;
+        for (size_t i = 0; i < matches.size() && result.size() < limit;) {
+            group.clear();
+            size_t j = i;
+            while (j < matches.size() && matches[j].shared == matches[i].shared &&
+                   matches[j].grams == matches[i].grams) {
+                const auto& positions = documentStudents[matches[j].document];
+                group.insert(group.end(), positions.begin(), positions.end());
+                j++;
+            }
+            sort(group.begin(), group.end());
+            double share = (double)matches[i].shared / queryGrams;
+            for (int32_t pos : group) {
+                if (result.size() == limit) break;
+                if (seen.insert(pos).second) result.push_back({&students[pos], share});
+            }
+            i = j;
+        }
+        return result;
+    }
+    
+    // All students with first <= indexNumber < last, in index order
+    vector<const Student*> findRange(const string& first, const string& last) const {
+        syncSortedOrder();
+        auto lower = lower_bound(sortedOrder.begin(), sortedOrder.end(), first,
+            [this](int32_t pos, const string& key) { return students[pos].getIndex() < key; });
+        
+        vector<const Student*> result;
+        for (auto it = lower; it != sortedOrder.end() && students[*it].getIndex() < last; ++it) {
+            result.push_back(&students[*it]);
+        }
+        return result;
+    }
+    
+    // All students whose index number starts with prefix, in index order
+    vector<const Student*> findByPrefix(const string& prefix) const {
+        syncSortedOrder();
+        auto lower = lower_bound(sortedOrder.begin(), sortedOrder.end(), prefix,
+            [this](int32_t pos, const string& key) { return students[pos].getIndex() < key; });
+        
+        vector<const Student*> result;
+        for (auto it = lower; it != sortedOrder.end(); ++it) {
+            string_view idx = students[*it].getIndex();
+            if (idx.compare(0, prefix.size(), prefix) != 0) break;
+            result.push_back(&students[*it]);
+        }
+        return result;
+    }
+};
+
+// ==============================
+// 9. ATTENDANCE STATUS SCHEMA
+// ==============================
+// The statuses a record can have, fixed at compile time. Each one has a
+// letter (as typed, and as stored in session text files), a label, and a
+// dense ordinal: its position in the table. Packed vectors, archives and
+// counters hold ordinals. Parsing, rendering and counting are lookups in
+// constexpr tables built from this one, and the packed lane width follows
+// from the number of statuses, so adding a status is one more row.
+
+struct StatusDefinition {
+    char code;
+    const char* label;
+    const char* name;  // lower case, for file columns and totals lines
+    bool attended;     // counts as attended
+    bool excused;      // left out of attendance rates
+};
+
+namespace statusschema {
+
+constexpr StatusDefinition STATUSES[] = {
+    {'P', "Present", "present", true, false},
+    {'A', "Absent", "absent", false, false},
+    {'L', "Late", "late", true, false},
+    {'E', "Excused", "excused", false, true},
+    {'M', "Medical", "medical", false, true},
+};
+
+constexpr size_t COUNT = sizeof(STATUSES) / sizeof(STATUSES[0]);
+constexpr uint8_t UNKNOWN = (uint8_t)COUNT; // ordinal of any other code
+constexpr size_t SLOTS = COUNT + 1;         // ordinals including UNKNOWN
+constexpr char DEFAULT_CODE = 'A';          // a record nobody has marked
+
+// Bits per packed status: just enough for every ordinal, UNKNOWN included.
+// A width that does not divide 64 leaves the top bits of each word unused.
+constexpr unsigned laneBits() {
+    unsigned bits = 1;
+    while ((1u << bits) < SLOTS) bits++;
+    return bits;
+}
+
+constexpr unsigned LANE_BITS = laneBits();
+static_assert(LANE_BITS <= 8, "status ordinals must fit in a byte");
+
+constexpr array<uint8_t, 256> buildOrdinals() {
+    array<uint8_t, 256> ordinals{};
+    for (size_t c = 0; c < ordinals.size(); c++) ordinals[c] = UNKNOWN;
+    for (size_t i = 0; i < COUNT; i++) ordinals[(unsigned char)STATUSES[i].code] = (uint8_t)i;
+    return ordinals;
+}
+
+// Code of every lane value; values past the schema read back as '?'
+constexpr array<char, (1u << LANE_BITS)> buildCodes() {
+    array<char, (1u << LANE_BITS)> codes{};
+    for (size_t i = 0; i < codes.size(); i++) codes[i] = i < COUNT ? STATUSES[i].code : '?';
+    return codes;
+}
+
+constexpr array<const char*, (1u << LANE_BITS)> buildLabels() {
+    array<const char*, (1u << LANE_BITS)> labels{};
+    for (size_t i = 0; i < labels.size(); i++) labels[i] = i < COUNT ? STATUSES[i].label : "Unknown";
+    return labels;
+}
+
+constexpr array<uint8_t, 256> ORDINALS = buildOrdinals();
+constexpr array<char, (1u << LANE_BITS)> CODES = buildCodes();
+constexpr array<const char*, (1u << LANE_BITS)> LABELS = buildLabels();
+
+static_assert(ORDINALS[(unsigned char)DEFAULT_CODE] != UNKNOWN, "default status must be in the schema");
+static_assert(ORDINALS['?'] == UNKNOWN, "'?' is reserved for unknown statuses");
+
+constexpr uint8_t ordinal(char code) { return ORDINALS[(unsigned char)code]; }
+constexpr char code(size_t ordinal) { return CODES[ordinal & ((1u << LANE_BITS) - 1)]; }
+constexpr const char* label(size_t ordinal) { return LABELS[ordinal & ((1u << LANE_BITS) - 1)]; }
+constexpr bool isValid(char code) { return ordinal(code) != UNKNOWN; }
+
+constexpr size_t labelLength(size_t ordinal) {
+    size_t n = 0;
+    while (STATUSES[ordinal].label[n] != '\0') n++;
+    return n;
+}
+
+// "P = Present, A = Absent, ..." for prompts
+inline string legend() {
+    string text;
+    for (size_t i = 0; i < COUNT; i++) {
+        if (i > 0) text += ", ";
+        text += STATUSES[i].code;
+        text += " = ";
+        text += STATUSES[i].label;
+    }
+    return text;
+}
+
+} // namespace statusschema
+
+// Number of records (or sessions) with each status, by ordinal
+template <typename Count>
+struct StatusTally {
+    array<Count, statusschema::SLOTS> byOrdinal{};
+    
+    Count& operator[](size_t ordinal) { return byOrdinal[ordinal]; }
+    Count operator[](size_t ordinal) const { return byOrdinal[ordinal]; }
+    Count of(char code) const { return byOrdinal[statusschema::ordinal(code)]; }
+    Count unknown() const { return byOrdinal[statusschema::UNKNOWN]; }
+    
+    // Every status in the schema
+    Count total() const {
+        Count sum = 0;
+        for (size_t i = 0; i < statusschema::COUNT; i++) sum += byOrdinal[i];
+        return sum;
+    }
+    
+    // Statuses an attendance rate is taken over (all but the excused ones)
+    Count rated() const {
+        Count sum = 0;
+        for (size_t i = 0; i < statusschema::COUNT; i++) {
+            if (!statusschema::STATUSES[i].excused) sum += byOrdinal[i];
+        }
+        return sum;
+    }
+    
+    Count attended() const {
+        Count sum = 0;
+        for (size_t i = 0; i < statusschema::COUNT; i++) {
+            if (statusschema::STATUSES[i].attended) sum += byOrdinal[i];
+        }
+        return sum;
+    }
+    
+    // Attended as a percentage of rated
+    double rate() const {
+        Count over = rated();
+        return over > 0 ? attended() * 100.0 / over : 0.0;
+    }
+    
+    StatusTally& operator+=(const StatusTally& other) {
+        for (size_t i = 0; i < statusschema::SLOTS; i++) byOrdinal[i] += other.byOrdinal[i];
+        return *this;
+    }
+    
+    bool operator==(const StatusTally& other) const { return byOrdinal == other.byOrdinal; }
+    bool operator!=(const StatusTally& other) const { return byOrdinal != other.byOrdinal; }
+};
+
+using StatusCounts = StatusTally<size_t>;
+
+// Report table columns holding one count per status
+inline size_t statusColumnsWidth() {
+    size_t width = 0;
+    for (size_t i = 0; i < statusschema::COUNT; i++) width += statusschema::labelLength(i) + 2;
+    return width;
+}
+
+inline void writeStatusHeadings(ReportWriter& out) {
+    for (size_t i = 0; i < statusschema::COUNT; i++) {
+        out.field(statusschema::STATUSES[i].label, statusschema::labelLength(i) + 2);
+    }
+}
+
+inline void writeStatusColumns(ReportWriter& out, const StatusCounts& counts) {
+    for (size_t i = 0; i < statusschema::COUNT; i++) {
+        out.field(to_string(counts[i]), statusschema::labelLength(i) + 2);
+    }
+}
+
+// "12 present, 3 absent, ..." followed by " (<rate>% attended)\n"
+inline void writeStatusTotals(ReportWriter& out, const StatusCounts& counts) {
+    for (size_t i = 0; i < statusschema::COUNT; i++) {
+        if (i > 0) out << ", ";
+        out << counts[i] << ' ' << statusschema::STATUSES[i].name;
+    }
+    out << " (";
+    out.fixed(counts.rate(), 1).text("% attended)\n");
+}
+
+// ==============================
+// 10. ATTENDANCE RECORD CLASS
+// ==============================
+class AttendanceRecord {
+private:
+    uint32_t studentId; // index number, interned
+    char status; // a code from the status schema, e.g. 'P' = Present
+    
+public:
+    AttendanceRecord() : studentId(0), status(statusschema::DEFAULT_CODE) {}
+    
+    AttendanceRecord(string_view idx, char s) : studentId(StringInterner::shared().intern(idx)), status(s) {}
+    
+    AttendanceRecord(uint32_t id, char s) : studentId(id), status(s) {}
+    
+    // Getters
+    string_view getStudentIndex() const { return StringInterner::shared()[studentId]; }
+    uint32_t getStudentId() const { return studentId; }
+    char getStatus() const { return status; }
+    
+    // Setters
+    void setStatus(char s) { status = s; }
+    
+    // Status codes accepted when marking
+    static bool isValidStatus(char s) {
+        return statusschema::isValid(s);
+    }
+    
+    // Display text for a status code
+    static const char* statusLabel(char s) {
+        return statusschema::label(statusschema::ordinal(s));
+    }
+    
+    // Display record; the caller supplies the already joined student name
+    void display(ReportWriter& out, string_view studentName) const {
+        out.field(getStudentIndex(), 15).field(studentName, 25).field(statusLabel(status), 10).line();
+    }
+    
+    // Convert to string for file storage
+    string toString() const {
+        string text(getStudentIndex());
+        text += ',';
+        text += status;
+        return text;
+    }
+    
+    // Load from string
+    static AttendanceRecord fromString(const string& data) {
+        size_t commaPos = data.find(',');
+        if (commaPos != string::npos) {
+            string_view idx = string_view(data).substr(0, commaPos);
+            char status = data.substr(commaPos + 1)[0];
+            return AttendanceRecord(idx, status);
+        }
+        return AttendanceRecord(0u, statusschema::DEFAULT_CODE);
+    }
+};
+
+// ==============================
+// 11. PACKED STATUS VECTOR
+// ==============================
+// Attendance statuses stored as schema ordinals in LANE_BITS-bit lanes
+// (3 bits, 21 per 64-bit word, for the five statuses), aligned to a
+// session's roster. Unused lanes in the last word are zero; the kernels
+// count them as ordinal 0 and countStatuses() takes them back out. Bits
+// above the last whole lane of a word are always zero.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ATTENDANCE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace statuskernels {
+
+using statusschema::LANE_BITS;
+
+// Bit 0 of every whole lane
+constexpr uint64_t laneLowBits() {
+    uint64_t bits = 0;
+    for (unsigned shift = 0; shift + LANE_BITS <= 64; shift += LANE_BITS) bits |= 1ULL << shift;
+    return bits;
+}
+
+constexpr uint64_t LANE_LOW = laneLowBits();
+constexpr size_t LANES_PER_WORD = 64 / LANE_BITS;
+
+inline size_t popcount64(uint64_t x) {
+#if defined(__GNUC__)
+    return (size_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (size_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Bit 0 of each lane of word that holds ordinal: XOR leaves those lanes
+// zero, and OR-ing each of a lane's upper bits onto its bit 0 finds the
+// nonzero ones. Each shift is applied to the XOR itself, so no bit of the
+// next lane is folded in when LANE_BITS is not a power of two.
+inline uint64_t matchLanes(uint64_t word, uint64_t ordinal) {
+    uint64_t diff = word ^ (ordinal * LANE_LOW);
+    uint64_t fold = diff;
+    for (unsigned shift = 1; shift < LANE_BITS; shift++) fold |= diff >> shift;
+    return ~fold & LANE_LOW;
+}
+
+// Adds the lanes holding each schema ordinal over words[begin, end)
+inline void countScalar(const uint64_t* words, size_t begin, size_t end, size_t counts[]) {
+    for (size_t i = begin; i < end; i++) {
+        for (size_t k = 0; k < statusschema::COUNT; k++) {
+            counts[k] += popcount64(matchLanes(words[i], k));
+        }
+    }
+}
+
+// Totals of `records` statuses from per-ordinal lane counts taken over
+// `lanes` lanes, the rest of which are zero padding
+inline StatusCounts finishCounts(const size_t counts[], size_t lanes, size_t records) {
+    StatusCounts result;
+    size_t known = 0;
+    for (size_t k = 0; k < statusschema::COUNT; k++) {
+        result[k] = counts[k];
+        known += counts[k];
+    }
+    result[0] -= lanes - records;
+    known -= lanes - records;
+    result[statusschema::UNKNOWN] = records - known;
+    return result;
+}
+
+#ifdef ATTENDANCE_X86_KERNELS
+// Byte-wise popcount through a nibble lookup table (pshufb), summed into
+// 64-bit lanes with psadbw
+__attribute__((target("avx2")))
+inline __m256i popcount256(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(v, low4);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low4);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+inline size_t sum256(__m256i v) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+__attribute__((target("avx2")))
+inline void countAVX2(const uint64_t* words, size_t n, size_t counts[]) {
+    const __m256i lowBits = _mm256_set1_epi64x((long long)LANE_LOW);
+    __m256i patterns[statusschema::COUNT];
+    __m256i totals[statusschema::COUNT];
+    for (size_t k = 0; k < statusschema::COUNT; k++) {
+        patterns[k] = _mm256_set1_epi64x((long long)(k * LANE_LOW));
+        totals[k] = _mm256_setzero_si256();
+    }
+    
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i w = _mm256_loadu_si256((const __m256i*)(words + i));
+        for (size_t k = 0; k < statusschema::COUNT; k++) {
+            __m256i diff = _mm256_xor_si256(w, patterns[k]);
+            __m256i fold = diff;
+            for (unsigned shift = 1; shift < LANE_BITS; shift++) {
+                fold = _mm256_or_si256(fold, _mm256_srl_epi64(diff, _mm_cvtsi32_si128((int)shift)));
+            }
+            totals[k] = _mm256_add_epi64(totals[k], popcount256(_mm256_andnot_si256(fold, lowBits)));
+        }
+    }
+    
+    for (size_t k = 0; k < statusschema::COUNT; k++) counts[k] += sum256(totals[k]);
+    countScalar(words, i, n, counts);
+}
+
+__attribute__((target("ssse3")))
+inline __m128i popcount128(__m128i v) {
+    const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low4 = _mm_set1_epi8(0x0f);
+    __m128i lo = _mm_and_si128(v, low4);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low4);
+    __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(lut, lo), _mm_shuffle_epi8(lut, hi));
+    return _mm_sad_epu8(bytes, _mm_setzero_si128());
+}
+
+__attribute__((target("ssse3")))
+inline size_t sum128(__m128i v) {
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, v);
+    return (size_t)(lanes[0] + lanes[1]);
+}
+
+__attribute__((target("ssse3")))
+inline void countSSSE3(const uint64_t* words, size_t n, size_t counts[]) {
+    const __m128i lowBits = _mm_set1_epi64x((long long)LANE_LOW);
+    __m128i patterns[statusschema::COUNT];
+    __m128i totals[statusschema::COUNT];
+    for (size_t k = 0; k < statusschema::COUNT; k++) {
+        patterns[k] = _mm_set1_epi64x((long long)(k * LANE_LOW));
+        totals[k] = _mm_setzero_si128();
+    }
+    
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i w = _mm_loadu_si128((const __m128i*)(words + i));
+        for (size_t k = 0; k < statusschema::COUNT; k++) {
+            __m128i diff = _mm_xor_si128(w, patterns[k]);
+            __m128i fold = diff;
+            for (unsigned shift = 1; shift < LANE_BITS; shift++) {
+                fold = _mm_or_si128(fold, _mm_srl_epi64(diff, _mm_cvtsi32_si128((int)shift)));
+            }
+            totals[k] = _mm_add_epi64(totals[k], popcount128(_mm_andnot_si128(fold, lowBits)));
+        }
+    }
+    
+    for (size_t k = 0; k < statusschema::COUNT; k++) counts[k] += sum128(totals[k]);
+    countScalar(words, i, n, counts);
+}
+#endif
+
+// Adds per-ordinal lane counts of n words into counts[statusschema::COUNT]
+typedef void (*CountKernel)(const uint64_t*, size_t, size_t[]);
+
+inline void countPortable(const uint64_t* words, size_t n, size_t counts[]) {
+    countScalar(words, 0, n, counts);
+}
+
+// Pick the widest kernel the running CPU supports (decided once)
+inline CountKernel selectKernel(const char** name = nullptr) {
+    static const char* selectedName = "scalar";
+    static const CountKernel selected = []() -> CountKernel {
+#ifdef ATTENDANCE_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            selectedName = "avx2";
+            return countAVX2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            selectedName = "ssse3";
+            return countSSSE3;
+        }
+#endif
+        return countPortable;
+    }();
+    if (name) *name = selectedName;
+    return selected;
+}
+
+} // namespace statuskernels
+
+class PackedStatusVector {
+public:
+    static constexpr unsigned BITS = statusschema::LANE_BITS;
+    static constexpr size_t PER_WORD = statuskernels::LANES_PER_WORD;
+    static constexpr uint64_t LANE_MASK = (1ULL << BITS) - 1;
+    
+private:
+    vector<uint64_t> words;
+    size_t count = 0;
+    
+    static size_t wordsFor(size_t n) { return (n + PER_WORD - 1) / PER_WORD; }
+    
+    // Zero the lanes of the last word past count
+    void clearPadding() {
+        if (count % PER_WORD != 0) {
+            words.back() &= (1ULL << (BITS * (count % PER_WORD))) - 1;
+        }
+    }
+    
+public:
+    // Lane values are schema ordinals; codes outside the schema are UNKNOWN
+    static uint64_t encode(char status) {
+        return statusschema::ordinal(status);
+    }
+    
+    static char decode(uint64_t code) {
+        return statusschema::code((size_t)(code & LANE_MASK));
+    }
+    
+    // Name of the summary kernel in use ("avx2", "ssse3" or "scalar")
+    static const char* kernelName() {
+        const char* name;
+        statuskernels::selectKernel(&name);
+        return name;
+    }
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t memoryBytes() const { return words.capacity() * sizeof(uint64_t); }
+    const vector<uint64_t>& data() const { return words; }
+    
+    void clear() {
+        words.clear();
+        count = 0;
+    }
+    
+    void reserve(size_t n) {
+        words.reserve(wordsFor(n));
+    }
+    
+    // Resize to n entries, all set to status
+    void assign(size_t n, char status) {
+        words.assign(wordsFor(n), encode(status) * statuskernels::LANE_LOW);
+        count = n;
+        clearPadding();
+    }
+    
+    void push_back(char status) {
+        if (count % PER_WORD == 0) words.push_back(0);
+        words.back() |= encode(status) << (BITS * (count % PER_WORD));
+        count++;
+    }
+    
+    char get(size_t i) const {
+        return decode(words[i / PER_WORD] >> (BITS * (i % PER_WORD)));
+    }
+    
+    void set(size_t i, char status) {
+        unsigned shift = BITS * (i % PER_WORD);
+        uint64_t& word = words[i / PER_WORD];
+        word = (word & ~(LANE_MASK << shift)) | (encode(status) << shift);
+    }
+    
+    // Replace the contents with n entries from raw (possibly unaligned) words
+    void assignWords(const void* raw, size_t n) {
+        words.resize(wordsFor(n));
+        if (!words.empty()) memcpy(words.data(), raw, words.size() * sizeof(uint64_t));
+        count = n;
+        // Unused lanes of the last word must stay zero for the kernels
+        clearPadding();
+    }
+    
+    // Replace the contents with n entries from words in an older layout:
+    // bits-bit lanes, 64 / bits per word, whose values are codes[value]
+    void assignLegacyWords(const void* raw, size_t n, unsigned bits, const char codes[]) {
+        size_t perWord = 64 / bits;
+        uint64_t mask = (1ULL << bits) - 1;
+        vector<uint64_t> legacy((n + perWord - 1) / perWord);
+        if (!legacy.empty()) memcpy(legacy.data(), raw, legacy.size() * sizeof(uint64_t));
+        clear();
+        reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            push_back(codes[(legacy[i / perWord] >> (bits * (i % perWord))) & mask]);
+        }
+    }
+    
+    // Per-status totals via the vectorized kernel
+    StatusCounts countStatuses() const {
+        size_t counts[statusschema::COUNT] = {};
+        statuskernels::selectKernel()(words.data(), words.size(), counts);
+        return statuskernels::finishCounts(counts, words.size() * PER_WORD, count);
+    }
+};
+
+// Statuses in fixed chunks of 48 words (1008 records) that can be shared,
+// so a session and the snapshots it has published hold one copy of every
+// chunk that has not changed since. share() hands the chunks out as
+// immutable; each shared chunk is then copied on its first write, and only
+// that chunk. Lanes are packed as in PackedStatusVector, and unused lanes
+// stay zero.
+class ChunkedStatusVector {
+public:
+    static constexpr size_t CHUNK_WORDS = 48; // a whole number of AVX2 and SSSE3 steps
+    static constexpr size_t CHUNK_RECORDS = CHUNK_WORDS * PackedStatusVector::PER_WORD;
+    using Chunk = array<uint64_t, CHUNK_WORDS>;
+    using SharedChunks = vector<shared_ptr<const Chunk>>;
+    
+private:
+    static constexpr size_t PER_WORD = PackedStatusVector::PER_WORD;
+    static constexpr unsigned BITS = PackedStatusVector::BITS;
+    
+    vector<shared_ptr<Chunk>> chunks;
+    vector<uint8_t> shared; // per chunk: also held by a snapshot, copy before writing
+    size_t count = 0;
+    
+    static size_t chunksFor(size_t n) { return (n + CHUNK_RECORDS - 1) / CHUNK_RECORDS; }
+    
+    // The word holding status i, made private to this vector first
+    uint64_t& writableWord(size_t i) {
+        size_t c = i / CHUNK_RECORDS;
+        if (shared[c]) {
+            chunks[c] = make_shared<Chunk>(*chunks[c]);
+            shared[c] = 0;
+        }
+        return (*chunks[c])[(i % CHUNK_RECORDS) / PER_WORD];
+    }
+    
+    // Zero the lanes past count in the last chunk
+    void clearPadding() {
+        if (count % CHUNK_RECORDS == 0) return;
+        Chunk& last = *chunks.back();
+        size_t used = count % CHUNK_RECORDS;
+        if (used % PER_WORD != 0) last[used / PER_WORD] &= (1ULL << (BITS * (used % PER_WORD))) - 1;
+        fill(last.begin() + (used + PER_WORD - 1) / PER_WORD, last.end(), 0);
+    }
+    
+public:
+    ChunkedStatusVector() = default;
+    ChunkedStatusVector(ChunkedStatusVector&&) = default;
+    ChunkedStatusVector& operator=(ChunkedStatusVector&&) = default;
+    
+    // A copy shares the chunks already shared (they are immutable) and takes
+    // its own copy of the others, so writes to either vector never show in
+    // the other
+    ChunkedStatusVector(const ChunkedStatusVector& other) : shared(other.shared), count(other.count) {
+        chunks.reserve(other.chunks.size());
+        for (size_t c = 0; c < other.chunks.size(); c++) {
+            chunks.push_back(shared[c] ? other.chunks[c] : make_shared<Chunk>(*other.chunks[c]));
+        }
+    }
+    
+    ChunkedStatusVector& operator=(const ChunkedStatusVector& other) {
+        if (this != &other) *this = ChunkedStatusVector(other);
+        return *this;
+    }
+    
+    // Status i of chunks in this layout (also used on a snapshot's chunks)
+    template <typename Chunks>
+    static char statusAt(const Chunks& in, size_t i) {
+        const Chunk& chunk = *in[i / CHUNK_RECORDS];
+        size_t lane = i % CHUNK_RECORDS;
+        return PackedStatusVector::decode(chunk[lane / PER_WORD] >> (BITS * (lane % PER_WORD)));
+    }
+    
+    // Per-status totals of the first records statuses of chunks
+    template <typename Chunks>
+    static StatusCounts countIn(const Chunks& in, size_t records) {
+        size_t counts[statusschema::COUNT] = {};
+        auto kernel = statuskernels::selectKernel();
+        for (const auto& chunk : in) {
+            kernel(chunk->data(), CHUNK_WORDS, counts);
+        }
+        return statuskernels::finishCounts(counts, in.size() * CHUNK_RECORDS, records);
+    }
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t chunkCount() const { return chunks.size(); }
+    const Chunk* chunkAt(size_t c) const { return chunks[c].get(); }
+    
+    size_t memoryBytes() const {
+        return chunks.size() * sizeof(Chunk) +
+               chunks.capacity() * (sizeof(shared_ptr<Chunk>) + sizeof(uint8_t));
+    }
+    
+    void clear() {
+        chunks.clear();
+        shared.clear();
+        count = 0;
+    }
+    
+    void reserve(size_t n) {
+        chunks.reserve(chunksFor(n));
+        shared.reserve(chunksFor(n));
+    }
+    
+    // Resize to n entries, all set to status
+    void assign(size_t n, char status) {
+        Chunk pattern;
+        pattern.fill(PackedStatusVector::encode(status) * statuskernels::LANE_LOW);
+        chunks.clear();
+        for (size_t c = 0; c < chunksFor(n); c++) chunks.push_back(make_shared<Chunk>(pattern));
+        shared.assign(chunks.size(), 0);
+        count = n;
+        clearPadding();
+    }
+    
+    // Replace the contents with n entries from raw (possibly unaligned) words
+    void assignWords(const void* raw, size_t n) {
+        const char* bytes = (const char*)raw;
+        size_t words = (n + PER_WORD - 1) / PER_WORD;
+        chunks.clear();
+        for (size_t first = 0; first < words; first += CHUNK_WORDS) {
+            shared_ptr<Chunk> chunk = make_shared<Chunk>();
+            chunk->fill(0);
+            memcpy(chunk->data(), bytes + first * sizeof(uint64_t),
+                   min(CHUNK_WORDS, words - first) * sizeof(uint64_t));
+            chunks.push_back(move(chunk));
+        }
+        shared.assign(chunks.size(), 0);
+        count = n;
+        clearPadding();
+    }
+    
+    void assign(const PackedStatusVector& flat) {
+        assignWords(flat.data().data(), flat.size());
+    }
+    
+    void push_back(char status) {
+        if (count % CHUNK_RECORDS == 0) {
+            chunks.push_back(make_shared<Chunk>());
+            chunks.back()->fill(0);
+            shared.push_back(0);
+        }
+        writableWord(count) |= PackedStatusVector::encode(status) << (BITS * (count % PER_WORD));
+        count++;
+    }
+    
+    char get(size_t i) const { return statusAt(chunks, i); }
+    
+    void set(size_t i, char status) {
+        unsigned shift = BITS * (i % PER_WORD);
+        uint64_t& word = writableWord(i);
+        word = (word & ~(PackedStatusVector::LANE_MASK << shift)) | (PackedStatusVector::encode(status) << shift);
+    }
+    
+    // The packed words of all entries, contiguous (for the binary format)
+    void copyWords(vector<uint64_t>& words) const {
+        words.resize((count + PER_WORD - 1) / PER_WORD);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            size_t first = c * CHUNK_WORDS;
+            size_t n = min(CHUNK_WORDS, words.size() - first);
+            copy(chunks[c]->begin(), chunks[c]->begin() + n, words.begin() + first);
+        }
+    }
+    
+    StatusCounts countStatuses() const { return countIn(chunks, count); }
+    
+    // Hand every chunk out as immutable; later writes copy a chunk first
+    SharedChunks share() {
+        shared.assign(chunks.size(), 1);
+        return SharedChunks(chunks.begin(), chunks.end());
+    }
+};
+
+// ==============================
+// 12. STRING TABLE
+// ==============================
+// A list of strings packed into one character pool plus an offset array,
+// so storing N strings costs two allocations instead of N.
+class StringTable {
+private:
+    string pool;
+    vector<uint32_t> offsets{0}; // offsets[i]..offsets[i + 1] spans string i
+    
+public:
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return offsets.size() == 1; }
+    size_t poolBytes() const { return pool.size(); }
+    
+    string_view operator[](size_t i) const {
+        return string_view(pool.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    
+    void clear() {
+        pool.clear();
+        offsets.assign(1, 0);
+    }
+    
+    void reserve(size_t count, size_t bytes) {
+        offsets.reserve(count + 1);
+        pool.reserve(bytes);
+    }
+    
+    void push_back(string_view str) {
+        pool.append(str.data(), str.size());
+        offsets.push_back((uint32_t)pool.size());
+    }
+    
+    // Raw layout for binary files: end offsets of each string, then the pool
+    const uint32_t* ends() const { return offsets.data() + 1; }
+    const char* poolData() const { return pool.data(); }
+    
+    // Replace the contents from a raw layout (possibly unaligned, e.g. inside
+    // a mapped file). Returns false if the end offsets are inconsistent.
+    bool assignRaw(const void* ends, size_t count, const char* data, size_t bytes) {
+        offsets.resize(count + 1);
+        offsets[0] = 0;
+        if (count > 0) memcpy(offsets.data() + 1, ends, count * sizeof(uint32_t));
+        for (size_t i = 0; i < count; i++) {
+            if (offsets[i + 1] < offsets[i]) {
+                clear();
+                return false;
+            }
+        }
+        if (offsets[count] != bytes) {
+            clear();
+            return false;
+        }
+        pool.assign(data, bytes);
+        return true;
+    }
+};
+
+// ==============================
+// 13. FILE UTILITIES
+// ==============================
+// Read-only view of a whole file: mmap where available, otherwise read
+// into memory
+class MappedFile {
+private:
+    const char* mapped = nullptr;
+    size_t length = 0;
+    string buffer;
+    
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    ~MappedFile() {
+#ifdef ATTENDANCE_POSIX
+        if (mapped && buffer.empty() && length > 0) {
+            munmap((void*)mapped, length);
+        }
+#endif
+    }
+    
+    bool open(const string& filename) {
+#ifdef ATTENDANCE_POSIX
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length > 0) {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            mapped = (const char*)p;
+        }
+        ::close(fd);
+        return true;
+#else
+        ifstream file(filename, ios::binary);
+        if (!file.is_open()) return false;
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        mapped = buffer.data();
+        length = buffer.size();
+        return true;
+#endif
+    }
+    
+    const char* data() const { return mapped; }
+    size_t size() const { return length; }
+};
+
+#ifdef ATTENDANCE_POSIX
+// Make a new or renamed directory entry for filename durable by fsyncing
+// the directory that holds it
+inline bool syncParentDirectory(const string& filename) {
+    size_t slash = filename.rfind('/');
+    string dir = slash == string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+#endif
+
+// Replace filename with contents so readers see either the old or the new
+// file, never a partial one: write a temp file, fsync it, rename it over,
+// then fsync the directory so the rename itself survives a crash
+inline bool writeFileAtomically(const string& filename, const string& contents) {
+    string tempName = filename + ".tmp";
+#ifdef ATTENDANCE_POSIX
+    int fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            ::unlink(tempName.c_str());
+            return false;
+        }
+        data += written;
+        remaining -= (size_t)written;
+    }
+    
+    if (::fsync(fd) != 0 || ::close(fd) != 0) {
+        ::unlink(tempName.c_str());
+        return false;
+    }
+    if (::rename(tempName.c_str(), filename.c_str()) != 0) return false;
+    return syncParentDirectory(filename);
+#else
+    {
+        ofstream file(tempName, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(contents.data(), contents.size());
+        file.close();
+        if (!file) return false;
+    }
+    // rename() does not replace an existing file everywhere
+    remove(filename.c_str());
+    return rename(tempName.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+// A line-oriented journal that is only ever appended to. Each append is
+// flushed to disk before returning; a line torn by a crash (no trailing
+// newline) is ignored on replay.
+class AppendOnlyLog {
+private:
+    string filename;
+#ifdef ATTENDANCE_POSIX
+    int fd = -1;
+#else
+    ofstream out;
+#endif
+    size_t entries = 0;
+    
+public:
+    explicit AppendOnlyLog(const string& name) : filename(name) {}
+    AppendOnlyLog(const AppendOnlyLog&) = delete;
+    AppendOnlyLog& operator=(const AppendOnlyLog&) = delete;
+    
+    ~AppendOnlyLog() {
+        close();
+    }
+    
+    const string& getFilename() const { return filename; }
+    
+    // Entries appended or replayed since the last reset
+    size_t size() const { return entries; }
+    
+    bool open() {
+#ifdef ATTENDANCE_POSIX
+        if (fd >= 0) return true;
+        bool existed = ::access(filename.c_str(), F_OK) == 0;
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return false;
+        // A journal created here must not vanish with its first entries
+        if (!existed && !syncParentDirectory(filename)) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        if (out.is_open()) return true;
+        out.open(filename, ios::binary | ios::app);
+        return out.is_open();
+#endif
+    }
+    
+    void close() {
+#ifdef ATTENDANCE_POSIX
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+#else
+        if (out.is_open()) out.close();
+#endif
+    }
+    
+    // Append one entry (without the newline) and make it durable
+    bool append(const string& entry) {
+        METRIC_TIMER(Metric::JournalAppend);
+        if (!open()) return false;
+        string line = entry + '\n';
+#ifdef ATTENDANCE_POSIX
+        // O_APPEND writes of a single buffer land contiguously
+        const char* data = line.data();
+        size_t remaining = line.size();
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            remaining -= (size_t)written;
+        }
+        if (::fsync(fd) != 0) return false;
+#else
+        out.write(line.data(), line.size());
+        out.flush();
+        if (!out) return false;
+#endif
+        entries++;
+        METRIC_IO(Metric::JournalAppend, line.size(), 1);
+        return true;
+    }
+    
+    // Call apply(line) for every complete entry; returns how many were read
+    template <typename Apply>
+    size_t replay(Apply apply) {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open()) return 0;
+        
+        size_t count = 0;
+        uintmax_t complete = 0; // bytes up to the end of the last whole entry
+        bool torn = false;
+        string line;
+        while (getline(file, line)) {
+            // getline stops at EOF without a newline only for a torn entry
+            if (file.eof()) {
+                torn = true;
+                break;
+            }
+            complete += line.size() + 1;
+            if (line.empty()) continue;
+            apply(line);
+            count++;
+        }
+        file.close();
+        
+        // Cut off a torn tail so later appends start on a fresh line
+        if (torn) {
+            close();
+            error_code ignored;
+            filesystem::resize_file(filename, complete, ignored);
+        }
+        
+        entries += count;
+        return count;
+    }
+    
+    // Empty the journal (after its entries were compacted elsewhere)
+    bool reset() {
+        close();
+        entries = 0;
+        ofstream file(filename, ios::binary | ios::trunc);
+        return file.is_open();
+    }
+};
+
+// ==============================
+// 14. CSV PARSER
+// ==============================
+// Splits CSV text into rows of string_view fields without copying: fields
+// point straight into the input (e.g. a MappedFile). Only quoted fields
+// containing "" escapes are unescaped, into a scratch buffer reused per row.
+// Handles quoted commas and newlines, CRLF line endings and any number of
+// columns.
+class CsvParser {
+private:
+    string_view text;
+    size_t pos = 0;
+    string scratch;
+    
+    struct FieldSpan {
+        bool inScratch;
+        size_t offset;
+        size_t length;
+    };
+    vector<FieldSpan> spans;
+    
+    // Parse one field starting at pos; leaves pos on the delimiter or end
+    FieldSpan parseField() {
+        if (pos < text.size() && text[pos] == '"') {
+            size_t start = ++pos;
+            size_t scratchStart = scratch.size();
+            bool escaped = false;
+            while (pos < text.size()) {
+                if (text[pos] == '"') {
+                    if (pos + 1 < text.size() && text[pos + 1] == '"') {
+                        // "" inside quotes is a literal quote: switch to scratch
+                        if (!escaped) {
+                            scratch.append(text.data() + start, pos - start);
+                            escaped = true;
+                        }
+                        scratch += '"';
+                        pos += 2;
+                        continue;
+                    }
+                    break;
+                }
+                if (escaped) scratch += text[pos];
+                pos++;
+            }
+            FieldSpan span = escaped
+                ? FieldSpan{true, scratchStart, scratch.size() - scratchStart}
+                : FieldSpan{false, start, pos - start};
+            if (pos < text.size()) pos++; // closing quote
+            // Anything between the closing quote and the delimiter is dropped
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '\n') pos++;
+            return span;
+        }
+        
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '\n') pos++;
+        size_t end = pos;
+        if (end > start && text[end - 1] == '\r') end--;
+        return FieldSpan{false, start, end - start};
+    }
+    
+public:
+    explicit CsvParser(string_view data) : text(data) {
+        // Skip a UTF-8 byte order mark
+        if (text.substr(0, 3) == "\xEF\xBB\xBF") pos = 3;
+    }
+    
+    // Read the next non-blank row into fields; false at end of input.
+    // Views stay valid until the next call.
+    bool nextRow(vector<string_view>& fields) {
+        fields.clear();
+        for (;;) {
+            if (pos >= text.size()) return false;
+            if (text[pos] == '\n') {
+                pos++;
+            } else if (text[pos] == '\r' && pos + 1 < text.size() && text[pos + 1] == '\n') {
+                pos += 2;
+            } else {
+                break;
+            }
+        }
+        
+        scratch.clear();
+        spans.clear();
+        for (;;) {
+            spans.push_back(parseField());
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+                continue;
+            }
+            if (pos < text.size()) pos++; // newline
+            break;
+        }
+        
+        for (const auto& span : spans) {
+            fields.push_back(span.inScratch
+                ? string_view(scratch).substr(span.offset, span.length)
+                : text.substr(span.offset, span.length));
+        }
+        return true;
+    }
+    
+    // Rough row count for pre-sizing (counts newlines)
+    static size_t estimateRows(string_view data) {
+        return (size_t)count(data.begin(), data.end(), '\n') + 1;
+    }
+};
+
+// Strip surrounding spaces and tabs from a field
+inline string_view trimField(string_view field) {
+    size_t first = field.find_first_not_of(" \t");
+    if (first == string_view::npos) return string_view();
+    size_t last = field.find_last_not_of(" \t");
+    return field.substr(first, last - first + 1);
+}
+
+// ==============================
+// 15. THREAD POOL
+// ==============================
+// A fixed set of worker threads for data-parallel loops. parallelFor()
+// splits the index range into one slice per thread; each thread works
+// through its own slice front to back and, once it runs dry, steals the
+// back half of another thread's slice. Uneven items (large and small
+// session files) therefore still balance across the workers.
+class ThreadPool {
+private:
+    struct alignas(64) Slice {
+        mutex lock;
+        size_t next = 0;
+        size_t end = 0;
+    };
+    
+    vector<thread> workers;
+    unique_ptr<Slice[]> slices; // workers.size() + 1; the last is the caller's
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    mutex runLock; // one parallelFor at a time
+    
+    const function<void(size_t)>* job = nullptr;
+    size_t busyWorkers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    
+    size_t sliceCount() const { return workers.size() + 1; }
+    
+    bool takeOwn(size_t self, size_t& index) {
+        Slice& slice = slices[self];
+        lock_guard<mutex> guard(slice.lock);
+        if (slice.next >= slice.end) return false;
+        index = slice.next++;
+        return true;
+    }
+    
+    // Move the back half of some other slice into ours; false if all empty
+    bool steal(size_t self) {
+        size_t n = sliceCount();
+        for (size_t k = 1; k < n; k++) {
+            Slice& victim = slices[(self + k) % n];
+            size_t first, last;
+            {
+                lock_guard<mutex> guard(victim.lock);
+                size_t remaining = victim.end - victim.next;
+                if (remaining == 0) continue;
+                first = victim.end - (remaining + 1) / 2;
+                last = victim.end;
+                victim.end = first;
+            }
+            Slice& own = slices[self];
+            lock_guard<mutex> guard(own.lock);
+            own.next = first;
+            own.end = last;
+            return true;
+        }
+        return false;
+    }
+    
+    void drain(size_t self) {
+        size_t index;
+        do {
+            while (takeOwn(self, index)) {
+                (*job)(index);
+            }
+        } while (steal(self));
+    }
+    
+    void workerLoop(size_t self) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                unique_lock<mutex> guard(lock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain(self);
+            {
+                lock_guard<mutex> guard(lock);
+                if (--busyWorkers == 0) finished.notify_one();
+            }
+        }
+    }
+    
+public:
+    // threads = 0 uses one worker per hardware thread (the caller also helps)
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) {
+            threads = max(1u, thread::hardware_concurrency()) - 1;
+        }
+        slices.reset(new Slice[threads + 1]);
+        for (size_t i = 0; i < threads; i++) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    // Threads that run a parallelFor, counting the calling thread
+    size_t concurrency() const { return workers.size() + 1; }
+    
+    // Run fn(i) for every i in [0, count); returns once all calls finished
+    void parallelFor(size_t count, const function<void(size_t)>& fn) {
+        if (count == 0) return;
+        lock_guard<mutex> running(runLock);
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+        
+        {
+            lock_guard<mutex> guard(lock);
+            job = &fn;
+            size_t n = sliceCount();
+            for (size_t i = 0; i < n; i++) {
+                lock_guard<mutex> sliceGuard(slices[i].lock);
+                slices[i].next = count * i / n;
+                slices[i].end = count * (i + 1) / n;
+            }
+            busyWorkers = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        
+        drain(workers.size());
+        
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&] { return busyWorkers == 0; });
+        job = nullptr;
+    }
+};
+
+// ==============================
+// 16. BINARY SESSION FORMAT
+// ==============================
+// session_<course>_<date>_<HHMM>.dat files, written in host byte order:
+//
+//   BinarySessionHeader
+//   uint32 metaEnds[3]            end offsets of course, date, start time
+//   char   metaPool[metaBytes]
+//   uint32 indexEnds[recordCount] end offsets of each student index
+//   char   indexPool[indexBytes]
+//   uint64 statusWords[(recordCount + PER_WORD - 1) / PER_WORD]
+//                                 PackedStatusVector words (schema ordinals,
+//                                 3-bit lanes, 21 per word)
+//
+// Older files are still read and are converted on load: version 1, from
+// before the status schema, holds 2-bit codes with 32 statuses per word,
+// and version 2 holds the ordinals of P, A, L, E, M in 4-bit lanes, 16 per
+// word. The checksum covers everything after the header. Files are read through
+// a MappedFile and copied section-by-section into the session, so a
+// load does a handful of allocations regardless of the record count.
+
+const char BINARY_SESSION_MAGIC[4] = {'D', 'A', 'S', 'B'};
+const uint16_t BINARY_SESSION_VERSION = 3;
+static_assert(PackedStatusVector::BITS == 3, "a new lane width needs a new binary session version");
+
+// Lane width and status of each lane value in the words of an older
+// version; bits is 0 for a version that was never written
+struct LegacyStatusLayout {
+    unsigned bits;
+    char codes[16];
+};
+
+inline LegacyStatusLayout legacyStatusLayout(uint16_t version) {
+    switch (version) {
+        case 1: return {2, {'A', 'P', 'L', '?'}};
+        case 2: return {4, {'P', 'A', 'L', 'E', 'M', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?'}};
+        default: return {0, {}};
+    }
+}
+
+struct BinarySessionHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t recordCount;
+    int32_t duration;
+    uint32_t metaBytes;
+    uint32_t indexBytes;
+    uint64_t payloadBytes;
+    uint64_t checksum;
+};
+
+// Word-at-a-time FNV-style checksum
+inline uint64_t checksum64(const char* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 1099511628211ULL;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) {
+        h = (h ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// True if the file starts with the binary session magic
+inline bool isBinarySessionFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[4];
+    return file.read(magic, 4) && memcmp(magic, BINARY_SESSION_MAGIC, 4) == 0;
+}
+
+// A single (student index, status) change for batch marking
+struct StatusUpdate {
+    string studentIndex;
+    char status;
+};
+
+// ==============================
+// 17. ATTENDANCE ANALYTICS
+// ==============================
+// Running per-student totals for each course, kept up to date by the
+// sessions themselves as records are added, marked or reloaded. Questions
+// like "who is below 75% in EEE227" then scan one counter per student
+// instead of every record of every session.
+
+// A student's totals over all sessions of one course. Late arrivals count
+// as attended; excused sessions are left out of the rate.
+using StudentAttendanceStats = StatusTally<uint32_t>;
+
+class CourseAnalytics {
+private:
+    vector<uint32_t> studentIds; // interned index number of each row
+    vector<StudentAttendanceStats> stats;
+    vector<int32_t> rowById;     // interned id -> row, -1 = none yet
+    
+    StudentAttendanceStats& statsFor(uint32_t studentId) {
+        if (studentId >= rowById.size()) {
+            rowById.resize(max<size_t>(studentId + 1, rowById.size() * 2), -1);
+        }
+        int32_t& row = rowById[studentId];
+        if (row == -1) {
+            row = (int32_t)stats.size();
+            studentIds.push_back(studentId);
+            stats.push_back(StudentAttendanceStats());
+        }
+        return stats[row];
+    }
+    
+    static uint32_t& counter(StudentAttendanceStats& s, char status) {
+        return s[statusschema::ordinal(status)];
+    }
+    
+public:
+    size_t studentCount() const { return stats.size(); }
+    string_view indexAt(size_t pos) const { return StringInterner::shared()[studentIds[pos]]; }
+    const StudentAttendanceStats& statsAt(size_t pos) const { return stats[pos]; }
+    
+    // Count a record in (sign = 1) or out (sign = -1)
+    void count(uint32_t studentId, char status, int sign) {
+        counter(statsFor(studentId), status) += sign;
+    }
+    
+    // A record's status changed from oldStatus to newStatus
+    void change(uint32_t studentId, char oldStatus, char newStatus) {
+        if (oldStatus == newStatus) return;
+        StudentAttendanceStats& s = statsFor(studentId);
+        counter(s, oldStatus)--;
+        counter(s, newStatus)++;
+    }
+    
+    // Positions of students whose attendance rate is below percent,
+    // lowest rate first
+    vector<size_t> belowThreshold(double percent) const {
+        vector<size_t> result;
+        for (size_t i = 0; i < stats.size(); i++) {
+            if (stats[i].rated() > 0 && stats[i].rate() < percent) {
+                result.push_back(i);
+            }
+        }
+        sort(result.begin(), result.end(), [this](size_t a, size_t b) {
+            return stats[a].rate() < stats[b].rate();
+        });
+        return result;
+    }
+    
+    // Positions of the n students with the highest attendance rate
+    vector<size_t> top(size_t n) const {
+        vector<size_t> result;
+        for (size_t i = 0; i < stats.size(); i++) {
+            if (stats[i].rated() > 0) result.push_back(i);
+        }
+        n = min(n, result.size());
+        partial_sort(result.begin(), result.begin() + n, result.end(), [this](size_t a, size_t b) {
+            if (stats[a].rate() != stats[b].rate()) return stats[a].rate() > stats[b].rate();
+            return stats[a].attended() > stats[b].attended();
+        });
+        result.resize(n);
+        return result;
+    }
+};
+
+class AttendanceAnalytics {
+private:
+    map<string, CourseAnalytics> courses; // node-based, so references stay valid
+    
+public:
+    CourseAnalytics& course(const string& courseCode) {
+        return courses[courseCode];
+    }
+    
+    const CourseAnalytics* findCourse(const string& courseCode) const {
+        auto it = courses.find(courseCode);
+        return it == courses.end() ? nullptr : &it->second;
+    }
+    
+    const map<string, CourseAnalytics>& allCourses() const { return courses; }
+};
+
+// ==============================
+// 18. SESSION SNAPSHOTS
+// ==============================
+// Readers never look at a session's live statuses: they take its published
+// snapshot, an immutable version of the header, roster and statuses. The
+// session's owner marks its working statuses and publishes a new version
+// after a batch of marks. The working statuses and the snapshots share
+// chunks of CHUNK_RECORDS (1008) records (ChunkedStatusVector): a chunk is
+// copied on its first write after a publish, so publishing only hands out
+// the chunk pointers, then swaps the published pointer atomically. A
+// report or export holding a snapshot therefore sees one consistent
+// version for as long as it runs, without taking the lock that marking
+// uses, and old versions are freed when their last reader lets go.
+
+// session_<course>_<date with underscores>_<HHMM>.txt, so sessions of a
+// course on the same day at different times get files of their own
+inline string sessionFilename(const string& courseCode, const string& date, const string& startTime) {
+    string formattedDate = date;
+    replace(formattedDate.begin(), formattedDate.end(), '-', '_');
+    string formattedTime = startTime;
+    formattedTime.erase(remove(formattedTime.begin(), formattedTime.end(), ':'), formattedTime.end());
+    return "session_" + courseCode + "_" + formattedDate + "_" + formattedTime + ".txt";
+}
+
+// session_<course>_<date with underscores>.txt, the name used before the
+// start time was part of it. Such files still load; a session loaded from
+// one moves to its new name when it is next saved.
+inline string legacySessionFilename(const string& courseCode, const string& date) {
+    string formattedDate = date;
+    replace(formattedDate.begin(), formattedDate.end(), '-', '_');
+    return "session_" + courseCode + "_" + formattedDate + ".txt";
+}
+
+// The .dat file next to a session's .txt file
+inline string binaryFilenameFor(const string& textFilename) {
+    return textFilename.substr(0, textFilename.size() - 4) + ".dat";
+}
+
+// Summary statistics of a session from its counts. The per-status figures
+// are shares of all records; the attendance rate leaves excused ones out,
+// as rate() does everywhere else.
+inline void writeSessionSummary(ReportWriter& out, const string& courseCode, const string& date,
+                                const StatusCounts& counts) {
+    size_t total = counts.total();
+    
+    out << "\nATTENDANCE SUMMARY:\n";
+    out << "==========================================\n";
+    out << "Course: " << courseCode << " (" << date << ")\n";
+    out << "Total Students: " << total << '\n';
+    for (size_t i = 0; i < statusschema::COUNT; i++) {
+        out << statusschema::STATUSES[i].label << ": " << counts[i] << " ("
+            << (total > 0 ? (counts[i] * 100 / total) : 0) << "% of all)\n";
+    }
+    out << "Attendance Rate: ";
+    out.fixed(counts.rate(), 1).text("% (excused not counted)\n");
+    out << "==========================================\n";
+}
+
+// Attendance list of a roster, with the status of position i from statusAt(i).
+// Names are joined through the registry's hash index (with a positional
+// fast path, since records are initialized in roster order), so a report
+// is linear in session size.
+template <typename StatusAt>
+void writeAttendanceList(ReportWriter& out, const StudentRegistry& students, const Roster& roster,
+                         StatusAt statusAt) {
+    constexpr string_view unknownName = "Unknown";
+    
+    out << "\nATTENDANCE LIST:\n";
+    out.field("Index Number", 15).field("Student Name", 25).field("Status", 10).line();
+    out.repeat('-', 50).line();
+    
+    for (size_t i = 0; i < roster.size(); i++) {
+        string_view idx = roster.indexAt(i);
+        const Student* student = nullptr;
+        if (i < students.size() && students[i].getIndexId() == roster[i]) {
+            student = &students[i];
+        } else {
+            student = students.get(idx);
+        }
+        out.field(idx, 15)
+           .field(student ? student->getName() : unknownName, 25)
+           .field(AttendanceRecord::statusLabel(statusAt(i)), 10)
+           .line();
+    }
+}
+
+// A session in the text file format
+template <typename StatusAt>
+string sessionText(const string& courseCode, const string& date, const string& startTime, int duration,
+                   const Roster& roster, StatusAt statusAt) {
+    string text;
+    text.reserve(64 + roster.size() * 12);
+    
+    // Session header
+    text += "COURSE:" + courseCode + "\n";
+    text += "DATE:" + date + "\n";
+    text += "TIME:" + startTime + "\n";
+    text += "DURATION:" + to_string(duration) + "\n";
+    text += "ATTENDANCE_RECORDS:\n";
+    
+    // Each record
+    for (size_t i = 0; i < roster.size(); i++) {
+        text += roster.indexAt(i);
+        text += ',';
+        text += statusAt(i);
+        text += '\n';
+    }
+    return text;
+}
+
+class SessionSnapshot {
+public:
+    using Chunk = ChunkedStatusVector::Chunk;
+    using Ref = shared_ptr<const SessionSnapshot>;
+    
+private:
+    friend class AttendanceSession;
+    
+    string courseCode;
+    string date;
+    string startTime;
+    int duration = 0;
+    Roster::Ref roster = Roster::empty();
+    ChunkedStatusVector::SharedChunks chunks; // unused lanes are zero
+    uint64_t version = 0;
+    string legacyFile; // removed once this version is written, if set
+    
+public:
+    const string& getCourseCode() const { return courseCode; }
+    const string& getDate() const { return date; }
+    const string& getStartTime() const { return startTime; }
+    int getDuration() const { return duration; }
+    string getFilename() const { return sessionFilename(courseCode, date, startTime); }
+    
+    // Published versions of a session are numbered 1, 2, ...
+    uint64_t getVersion() const { return version; }
+    
+    size_t getRecordCount() const { return roster->size(); }
+    const Roster::Ref& getRoster() const { return roster; }
+    string_view getStudentIndex(size_t pos) const { return roster->indexAt(pos); }
+    
+    // Versions published by all sessions so far, for change-driven saving
+    static atomic<uint64_t>& publishedTotal() {
+        static atomic<uint64_t> total{0};
+        return total;
+    }
+    
+    int findRecord(string_view studentIndex) const { return roster->find(studentIndex); }
+    
+    char getStatus(size_t pos) const {
+        return ChunkedStatusVector::statusAt(chunks, pos);
+    }
+    
+    // Bytes of the snapshot itself, chunks excluded
+    size_t overheadBytes() const {
+        return sizeof(*this) + chunks.capacity() * sizeof(shared_ptr<const Chunk>);
+    }
+    
+    size_t memoryBytes() const {
+        return overheadBytes() + chunks.size() * sizeof(Chunk);
+    }
+    
+    StatusCounts countStatuses() const {
+        return ChunkedStatusVector::countIn(chunks, roster->size());
+    }
+    
+    void displayHeader(ReportWriter& out) const {
+        out << "\n==========================================\n";
+        out << "SESSION: " << courseCode << '\n';
+        out << "DATE: " << date << '\n';
+        out << "TIME: " << startTime << " (" << duration << " hours)\n";
+        out << "==========================================\n";
+    }
+    
+    void displayAttendance(const StudentRegistry& students, ReportWriter& out) const {
+        METRIC_TIMER(Metric::ReportAttendance);
+        writeAttendanceList(out, students, *roster, [this](size_t i) { return getStatus(i); });
+    }
+    
+    void displaySummary(ReportWriter& out) const {
+        METRIC_TIMER(Metric::ReportSummary);
+        writeSessionSummary(out, courseCode, date, countStatuses());
+    }
+    
+    string toText() const {
+        return sessionText(courseCode, date, startTime, duration, *roster,
+                           [this](size_t i) { return getStatus(i); });
+    }
+    
+    // Write this version to the session's file atomically; prints nothing
+    bool writeToFile() const {
+        METRIC_TIMER(Metric::SaveSessionText);
+        string text = toText();
+        if (!writeFileAtomically(getFilename(), text)) return false;
+        METRIC_IO(Metric::SaveSessionText, text.size(), roster->size());
+        if (!legacyFile.empty()) remove(legacyFile.c_str());
+        return true;
+    }
+};
+
+// ==============================
+// 19. ATTENDANCE SESSION CLASS
+// ==============================
+class AttendanceSession {
+private:
+    string courseCode;
+    string date;
+    string startTime;
+    int duration; // in hours
+    
+    // Records are stored column-wise: a shared, immutable roster of student
+    // ids plus packed statuses aligned with it, in chunks shared with the
+    // published snapshot until they are written
+    Roster::Ref roster = Roster::empty();
+    ChunkedStatusVector statuses;
+    
+    // Changed since last saved to (or loaded from) its own file
+    bool dirty = true;
+    
+    // File under the old naming scheme this session was loaded from, if
+    // any; it goes once the session is written under its new name
+    string legacyFile;
+    
+    // Latest version for readers, and whether the records have changed since
+    SessionSnapshot::Ref published;
+    bool unpublished = true;
+    
+    // Cross-session counters this session reports into, if attached
+    AttendanceAnalytics* analytics = nullptr;
+    CourseAnalytics* courseStats = nullptr;
+    
+    string_view keyAt(int pos) const { return roster->indexAt((size_t)pos); }
+    
+    // Count every record into (sign = 1) or out of (-1) the course counters
+    void countRecords(int sign) {
+        if (!courseStats) return;
+        for (size_t i = 0; i < roster->size(); i++) {
+            courseStats->count((*roster)[i], statuses.get(i), sign);
+        }
+    }
+    
+    // Bracket a wholesale replacement of the records (and maybe the course)
+    void beginReload() {
+        countRecords(-1);
+        unpublished = true;
+    }
+    
+    void endReload() {
+        courseStats = analytics ? &analytics->course(courseCode) : nullptr;
+        countRecords(1);
+        publish();
+    }
+    
+    void setStatusAt(size_t slot, char status) {
+        if (courseStats) {
+            courseStats->change((*roster)[slot], statuses.get(slot), status);
+        }
+        statuses.set(slot, status);
+        unpublished = true;
+    }
+    
+    // Note a file just read as the session's old-style file, to be removed
+    // when the session is saved under its current name
+    void rememberLegacyFile(const string& filename, const string& legacyName) {
+        legacyFile = filename == legacyName ? filename : string();
+    }
+    
+    // Position of a student's record, or -1 (the roster's shared lookup)
+    int findSlot(string_view studentIndex) const {
+        return roster->find(studentIndex);
+    }
+    
+public:
+    AttendanceSession() : courseCode(""), date(""), startTime(""), duration(0) {
+        publish();
+    }
+    
+    AttendanceSession(string course, string d, string time, int dur) 
+        : courseCode(course), date(d), startTime(time), duration(dur) {
+        publish();
+    }
+    
+    // Getters
+    const string& getCourseCode() const { return courseCode; }
+    const string& getDate() const { return date; }
+    const string& getStartTime() const { return startTime; }
+    int getDuration() const { return duration; }
+    size_t getRecordCount() const { return roster->size(); }
+    string_view getStudentIndex(size_t pos) const { return keyAt((int)pos); }
+    uint32_t getStudentId(size_t pos) const { return (*roster)[pos]; }
+    const Roster::Ref& getRoster() const { return roster; }
+    int findRecord(string_view studentIndex) const { return findSlot(studentIndex); }
+    char getStatus(size_t pos) const { return statuses.get(pos); }
+    const ChunkedStatusVector& getStatuses() const { return statuses; }
+    bool isDirty() const { return dirty; }
+    
+    // Bytes held by the records and the published version; a roster shared
+    // with other sessions is not counted here, nor is a chunk twice
+    size_t memoryBytes() const {
+        bool sharedRoster = roster.use_count() > (published->roster == roster ? 2 : 1);
+        size_t bytes = sizeof(*this) + statuses.memoryBytes() + published->overheadBytes() +
+                       (sharedRoster ? 0 : roster->memoryBytes());
+        // Chunks of the published version since replaced by a copy
+        for (size_t c = 0; c < published->chunks.size(); c++) {
+            if (c >= statuses.chunkCount() || published->chunks[c].get() != statuses.chunkAt(c)) {
+                bytes += sizeof(SessionSnapshot::Chunk);
+            }
+        }
+        return bytes;
+    }
+    
+    // Make the working records the published version. The snapshot takes
+    // the status chunks as they are; a chunk is copied only when it is next
+    // written. Writers call this after each batch of marks (the bulk
+    // mutators do it themselves); single updateRecord/addRecord calls are
+    // left pending.
+    void publish() {
+        if (!unpublished) return;
+        METRIC_TIMER(Metric::PublishSnapshot);
+        
+        shared_ptr<SessionSnapshot> next = make_shared<SessionSnapshot>();
+        next->courseCode = courseCode;
+        next->date = date;
+        next->startTime = startTime;
+        next->duration = duration;
+        next->roster = roster;
+        next->version = published ? published->version + 1 : 1;
+        next->legacyFile = legacyFile;
+        
+        next->chunks = statuses.share();
+        
+        atomic_store(&published, SessionSnapshot::Ref(move(next)));
+        SessionSnapshot::publishedTotal()++;
+        unpublished = false;
+    }
+    
+    // The latest published version. Safe to call while another thread
+    // marks this session; the snapshot stays valid and unchanged for as
+    // long as the caller holds it.
+    SessionSnapshot::Ref snapshot() const { return atomic_load(&published); }
+    
+    // Publish anything pending, then return the latest version
+    SessionSnapshot::Ref current() {
+        publish();
+        return published;
+    }
+    
+    // A snapshot of this version was written to the session's file; the
+    // session is clean unless it has changed since
+    void markSaved(uint64_t version) {
+        if (!unpublished && published->getVersion() == version) dirty = false;
+    }
+    
+    // Report this session's records into analytics (nullptr detaches)
+    void attachAnalytics(AttendanceAnalytics* target) {
+        countRecords(-1);
+        analytics = target;
+        courseStats = nullptr;
+        endReload();
+    }
+    
+    // Replace the records with aligned columns (e.g. decoded from an archive)
+    void assignRecords(const vector<uint32_t>& ids, PackedStatusVector&& newStatuses) {
+        beginReload();
+        roster = Roster::fromIds(ids);
+        statuses.assign(newStatuses);
+        dirty = true;
+        endReload();
+    }
+    
+    // Records materialized as AttendanceRecord values
+    vector<AttendanceRecord> getRecords() const {
+        vector<AttendanceRecord> records;
+        records.reserve(roster->size());
+        for (size_t i = 0; i < roster->size(); i++) {
+            records.push_back(AttendanceRecord((*roster)[i], statuses.get(i)));
+        }
+        return records;
+    }
+    
+    // Get filename for this session
+    string getFilename() const {
+        return sessionFilename(courseCode, date, startTime);
+    }
+    
+    // Get filename for the binary form of this session
+    string getBinaryFilename() const {
+        return binaryFilenameFor(getFilename());
+    }
+    
+    // Add a record (the session moves to its own new roster version)
+    void addRecord(const AttendanceRecord& record) {
+        roster = roster->append(record.getStudentId());
+        statuses.push_back(record.getStatus());
+        unpublished = true;
+        dirty = true;
+        if (courseStats) courseStats->count(record.getStudentId(), record.getStatus(), 1);
+    }
+    
+    // Update a record
+    bool updateRecord(string_view studentIndex, char status) {
+        METRIC_SAMPLED_TIMER(Metric::MarkRecord);
+        int slot = findSlot(studentIndex);
+        if (slot == -1) return false;
+        setStatusAt(slot, status);
+        dirty = true;
+        return true;
+    }
+    
+    // Apply a batch of updates in one pass through the roster's lookup. Returns
+    // how many matched a record; indexes not in this session are appended to
+    // unmatched when it is given.
+    size_t applyUpdates(const vector<StatusUpdate>& updates, vector<string>* unmatched = nullptr) {
+        METRIC_TIMER(Metric::ApplyUpdates);
+        size_t applied = 0;
+        for (const auto& update : updates) {
+            int slot = findSlot(update.studentIndex);
+            if (slot != -1) {
+                setStatusAt(slot, update.status);
+                applied++;
+            } else if (unmatched) {
+                unmatched->push_back(update.studentIndex);
+            }
+        }
+        if (applied > 0) {
+            dirty = true;
+            publish();
+        }
+        return applied;
+    }
+    
+    // Apply statuses aligned position-for-position with the records (as
+    // created by initializeRecords); '\0' entries leave a record unchanged.
+    size_t applyStatuses(const vector<char>& marks) {
+        METRIC_TIMER(Metric::ApplyStatuses);
+        size_t n = min(marks.size(), roster->size());
+        size_t applied = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (marks[i] != '\0') {
+                setStatusAt(i, marks[i]);
+                applied++;
+            }
+        }
+        if (applied > 0) {
+            dirty = true;
+            publish();
+        }
+        return applied;
+    }
+    
+    // Initialize records for every student of a roster version, all
+    // Absent. The roster is shared, not copied.
+    void initializeRecords(Roster::Ref students) {
+        beginReload();
+        roster = move(students);
+        statuses.assign(roster->size(), statusschema::DEFAULT_CODE); // Default: Absent
+        dirty = true;
+        endReload();
+    }
+    
+    void initializeRecords(const vector<Student>& students) {
+        vector<uint32_t> ids;
+        ids.reserve(students.size());
+        for (const auto& student : students) {
+            ids.push_back(student.getIndexId());
+        }
+        initializeRecords(Roster::fromIds(ids));
+    }
+    
+    // Move to a newer version of this session's roster (one it is a prefix
+    // of, e.g. after more registrations); the added students start Absent.
+    // Returns how many records were added.
+    size_t extendRoster(const Roster::Ref& newer) {
+        if (newer->size() <= roster->size() || !roster->isPrefixOf(*newer)) return 0;
+        size_t added = newer->size() - roster->size();
+        unpublished = true;
+        for (size_t i = roster->size(); i < newer->size(); i++) {
+            statuses.push_back(statusschema::DEFAULT_CODE);
+            if (courseStats) courseStats->count((*newer)[i], statusschema::DEFAULT_CODE, 1);
+        }
+        roster = newer;
+        dirty = true;
+        publish();
+        return added;
+    }
+    
+    // Point at an equal roster held elsewhere, so the two share memory.
+    // Returns true if other has the same records.
+    bool shareRoster(const Roster::Ref& other) {
+        if (roster == other) return true;
+        if (!roster->sameAs(*other)) return false;
+        roster = other;
+        return true;
+    }
+    
+    // Display session info
+    void displayHeader(ReportWriter& out) const {
+        out << "\n==========================================\n";
+        out << "SESSION: " << courseCode << '\n';
+        out << "DATE: " << date << '\n';
+        out << "TIME: " << startTime << " (" << duration << " hours)\n";
+        out << "==========================================\n";
+    }
+    
+    void displayHeader() const {
+        ReportWriter out;
+        displayHeader(out);
+    }
+    
+    // Display attendance list
+    void displayAttendance(const StudentRegistry& students, ReportWriter& out) const {
+        METRIC_TIMER(Metric::ReportAttendance);
+        writeAttendanceList(out, students, *roster, [this](size_t i) { return statuses.get(i); });
+    }
+    
+    void displayAttendance(const StudentRegistry& students) const {
+        ReportWriter out;
+        displayAttendance(students, out);
+    }
+    
+    // Per-status totals, counted over the packed statuses
+    StatusCounts countStatuses() const {
+        return statuses.countStatuses();
+    }
+    
+    // Generate summary statistics
+    void displaySummary(ReportWriter& out) const {
+        METRIC_TIMER(Metric::ReportSummary);
+        writeSessionSummary(out, courseCode, date, countStatuses());
+    }
+    
+    void displaySummary() const {
+        ReportWriter out;
+        displaySummary(out);
+    }
+    
+    // Session in the text file format
+    string toText() const {
+        return sessionText(courseCode, date, startTime, duration, *roster,
+                           [this](size_t i) { return statuses.get(i); });
+    }
+    
+    // Write the session to its file atomically without printing anything,
+    // so it can run on a worker thread; clears the dirty flag on success
+    bool writeToFile() {
+        METRIC_TIMER(Metric::SaveSessionText);
+        string text = toText();
+        if (!writeFileAtomically(getFilename(), text)) return false;
+        METRIC_IO(Metric::SaveSessionText, text.size(), roster->size());
+        dirty = false;
+        return true;
+    }
+    
+    // Save session in the binary format
+    bool saveToBinaryFile(const string& filename) const {
+        METRIC_TIMER(Metric::SaveSessionBinary);
+        const string* meta[3] = {&courseCode, &date, &startTime};
+        uint32_t metaEnds[3];
+        uint32_t metaBytes = 0;
+        for (int i = 0; i < 3; i++) {
+            metaBytes += (uint32_t)meta[i]->size();
+            metaEnds[i] = metaBytes;
+        }
+        
+        size_t recordCount = roster->size();
+        vector<uint64_t> words;
+        statuses.copyWords(words);
+        
+        // Index numbers are written out as end offsets plus one pool, so the
+        // file does not depend on this run's interned ids
+        vector<uint32_t> indexEnds(recordCount);
+        uint32_t indexBytes = 0;
+        for (size_t i = 0; i < recordCount; i++) {
+            indexBytes += (uint32_t)keyAt((int)i).size();
+            indexEnds[i] = indexBytes;
+        }
+        
+        // Build the payload in one buffer so it is checksummed and written once
+        string payload;
+        payload.reserve(sizeof(metaEnds) + metaBytes + recordCount * sizeof(uint32_t) +
+                        indexBytes + words.size() * sizeof(uint64_t));
+        payload.append((const char*)metaEnds, sizeof(metaEnds));
+        for (int i = 0; i < 3; i++) {
+            payload.append(*meta[i]);
+        }
+        payload.append((const char*)indexEnds.data(), recordCount * sizeof(uint32_t));
+        for (size_t i = 0; i < recordCount; i++) {
+            payload.append(keyAt((int)i));
+        }
+        payload.append((const char*)words.data(), words.size() * sizeof(uint64_t));
+        
+        BinarySessionHeader header;
+        memcpy(header.magic, BINARY_SESSION_MAGIC, 4);
+        header.version = BINARY_SESSION_VERSION;
+        header.headerSize = sizeof(BinarySessionHeader);
+        header.recordCount = (uint32_t)recordCount;
+        header.duration = duration;
+        header.metaBytes = metaBytes;
+        header.indexBytes = indexBytes;
+        header.payloadBytes = payload.size();
+        header.checksum = checksum64(payload.data(), payload.size());
+        payload.insert(0, (const char*)&header, sizeof(header));
+        
+        if (!writeFileAtomically(filename, payload)) {
+            cout << "Error: Could not save session to file!" << endl;
+            return false;
+        }
+        METRIC_IO(Metric::SaveSessionBinary, payload.size(), recordCount);
+        cout << "Session saved to: " << filename << endl;
+        return true;
+    }
+    
+    // Read a binary session file through a memory mapping. Prints nothing;
+    // on failure returns false with the reason in error.
+    bool readBinaryFile(const string& filename, const vector<Student>& students, string& error) {
+        METRIC_TIMER(Metric::LoadSessionBinary);
+        MappedFile file;
+        if (!file.open(filename)) {
+            error = "Could not load session file!";
+            return false;
+        }
+        
+        BinarySessionHeader header;
+        if (file.size() < sizeof(header)) {
+            error = "Session file is truncated!";
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        
+        if (memcmp(header.magic, BINARY_SESSION_MAGIC, 4) != 0 ||
+            header.headerSize != sizeof(header)) {
+            error = "Not a binary session file!";
+            return false;
+        }
+        bool legacy = header.version != BINARY_SESSION_VERSION;
+        LegacyStatusLayout layout = legacyStatusLayout(header.version);
+        if (legacy && layout.bits == 0) {
+            error = "Unsupported session file version " + to_string(header.version) + "!";
+            return false;
+        }
+        
+        size_t recordCount = header.recordCount;
+        size_t perWord = legacy ? 64 / layout.bits : PackedStatusVector::PER_WORD;
+        size_t wordCount = (recordCount + perWord - 1) / perWord;
+        uint64_t expected = 3 * sizeof(uint32_t) + (uint64_t)header.metaBytes +
+                            recordCount * sizeof(uint32_t) + header.indexBytes +
+                            wordCount * sizeof(uint64_t);
+        if (header.payloadBytes != expected || file.size() - sizeof(header) < expected) {
+            error = "Session file is truncated!";
+            return false;
+        }
+        
+        const char* payload = file.data() + sizeof(header);
+        if (checksum64(payload, header.payloadBytes) != header.checksum) {
+            error = "Session file checksum mismatch!";
+            return false;
+        }
+        
+        // Session info strings
+        const char* cursor = payload;
+        StringTable meta;
+        if (!meta.assignRaw(cursor, 3, cursor + 3 * sizeof(uint32_t), header.metaBytes)) {
+            error = "Session file is corrupt!";
+            return false;
+        }
+        cursor += 3 * sizeof(uint32_t) + header.metaBytes;
+        
+        // Student indexes and statuses, copied section-by-section
+        beginReload();
+        const char* indexEnds = cursor;
+        cursor += recordCount * sizeof(uint32_t);
+        StringTable indexes;
+        if (!indexes.assignRaw(indexEnds, recordCount, cursor, header.indexBytes)) {
+            roster = Roster::empty();
+            statuses.clear();
+            endReload();
+            error = "Session file is corrupt!";
+            return false;
+        }
+        cursor += header.indexBytes;
+        vector<string_view> views(recordCount);
+        for (size_t i = 0; i < recordCount; i++) {
+            views[i] = indexes[i];
+        }
+        vector<uint32_t> ids;
+        StringInterner::shared().internAll(views, ids);
+        roster = Roster::fromIds(ids);
+        if (legacy) {
+            PackedStatusVector converted;
+            converted.assignLegacyWords(cursor, recordCount, layout.bits, layout.codes);
+            statuses.assign(converted);
+        } else {
+            statuses.assignWords(cursor, recordCount);
+        }
+        
+        courseCode = string(meta[0]);
+        date = string(meta[1]);
+        startTime = string(meta[2]);
+        duration = header.duration;
+        rememberLegacyFile(filename, binaryFilenameFor(legacySessionFilename(courseCode, date)));
+        
+        endReload();
+        METRIC_IO(Metric::LoadSessionBinary, file.size(), recordCount);
+        
+        // If no records were loaded, initialize with current students
+        if (roster->isEmpty()) {
+            initializeRecords(students);
+        } else {
+            dirty = filename != getBinaryFilename();
+        }
+        return true;
+    }
+    
+    // Read a text session file. The file is mapped and parsed in place with
+    // string_views; index numbers are then interned in one batch, so the
+    // only allocations are the session's own columns.
+    // Prints nothing; on failure returns false with the reason in error.
+    bool readTextFile(const string& filename, const vector<Student>& students, string& error) {
+        METRIC_TIMER(Metric::LoadSessionText);
+        MappedFile file;
+        if (!file.open(filename)) {
+            error = "Could not load session file!";
+            return false;
+        }
+        string_view text(file.data(), file.size());
+        
+        beginReload();
+        roster = Roster::empty();
+        statuses.clear();
+        
+        // Roughly one record per line
+        size_t lines = (size_t)count(text.begin(), text.end(), '\n');
+        vector<string_view> indexes;
+        indexes.reserve(lines);
+        statuses.reserve(lines);
+        
+        bool readingRecords = false;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == string_view::npos) end = text.size();
+            string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty()) continue;
+            
+            if (readingRecords) {
+                // Read attendance records ("index,status")
+                size_t commaPos = line.find(',');
+                if (commaPos != string_view::npos) {
+                    indexes.push_back(line.substr(0, commaPos));
+                    statuses.push_back(commaPos + 1 < line.size() ? line[commaPos + 1] : '\0');
+                } else {
+                    indexes.push_back(string_view());
+                    statuses.push_back(statusschema::DEFAULT_CODE);
+                }
+            } else if (line == "ATTENDANCE_RECORDS:") {
+                readingRecords = true;
+            } else if (line.substr(0, 7) == "COURSE:") {
+                // Read session info
+                courseCode = string(line.substr(7));
+            } else if (line.substr(0, 5) == "DATE:") {
+                date = string(line.substr(5));
+            } else if (line.substr(0, 5) == "TIME:") {
+                startTime = string(line.substr(5));
+            } else if (line.substr(0, 9) == "DURATION:") {
+                string_view value = line.substr(9);
+                if (from_chars(value.data(), value.data() + value.size(), duration).ec != errc()) {
+                    statuses.clear();
+                    endReload();
+                    error = "Invalid duration in session file!";
+                    return false;
+                }
+            }
+        }
+        
+        vector<uint32_t> ids;
+        StringInterner::shared().internAll(indexes, ids);
+        roster = Roster::fromIds(ids);
+        rememberLegacyFile(filename, legacySessionFilename(courseCode, date));
+        endReload();
+        METRIC_IO(Metric::LoadSessionText, file.size(), ids.size());
+        
+        // If no records were loaded, initialize with current students
+        if (roster->isEmpty()) {
+            initializeRecords(students);
+        } else {
+            dirty = filename != getFilename();
+        }
+        return true;
+    }
+    
+    // Read a session file of either format (detected from the contents)
+    // without printing, e.g. from a worker thread
+    bool readFromFile(const string& filename, const vector<Student>& students, string& error) {
+        if (isBinarySessionFile(filename)) {
+            return readBinaryFile(filename, students, error);
+        }
+        return readTextFile(filename, students, error);
+    }
+    
+    // Load session from a binary file
+    bool loadFromBinaryFile(const string& filename, const vector<Student>& students) {
+        string error;
+        if (!readBinaryFile(filename, students, error)) {
+            cout << "Error: " << error << endl;
+            return false;
+        }
+        cout << "Session loaded from: " << filename << endl;
+        return true;
+    }
+    
+    // Load session from file (text or binary, detected from the contents)
+    bool loadFromFile(const string& filename, const vector<Student>& students) {
+        string error;
+        if (!readFromFile(filename, students, error)) {
+            cout << "Error: " << error << endl;
+            return false;
+        }
+        cout << "Session loaded from: " << filename << endl;
+        return true;
+    }
+};
+
+// ==============================
+// 20. SUMMARY REPORT ENGINE
+// ==============================
+// The attendance summary over many sessions, built in two passes. The
+// compute pass splits the sessions into blocks that are counted on the
+// thread pool, each block also rolling its sessions up per course; block
+// rollups are merged in block order, so the result does not depend on which
+// thread ran what. The render pass formats each block into its own buffer,
+// again in parallel, and the buffers are written out in session order.
+// The report holds the snapshots it was built from, so it is consistent
+// even if the sessions are marked while it runs.
+
+struct CourseRollup {
+    string courseCode;
+    size_t sessions = 0;
+    StatusCounts counts;
+    size_t lowestSession = 0; // position of the session with the lowest attendance
+    double lowestRate = 0.0;
+    
+    double rate() const { return counts.rate(); }
+};
+
+class SummaryReport {
+private:
+    vector<SessionSnapshot::Ref> snapshots;
+    vector<StatusCounts> sessionCounts; // aligned with the snapshots
+    vector<CourseRollup> courses;       // by course code
+    StatusCounts totals;
+    
+    // Fold one session (or another rollup) in; ties keep the earlier session
+    static void merge(CourseRollup& into, const CourseRollup& from) {
+        if (into.sessions == 0 || from.lowestRate < into.lowestRate) {
+            into.lowestSession = from.lowestSession;
+            into.lowestRate = from.lowestRate;
+        }
+        into.sessions += from.sessions;
+        into.counts += from.counts;
+    }
+    
+    static size_t blocksFor(size_t sessions, const ThreadPool& pool) {
+        return min(sessions, pool.concurrency() * 4);
+    }
+    
+public:
+    void build(vector<SessionSnapshot::Ref> versions, ThreadPool& pool) {
+        snapshots = move(versions);
+        const auto& sessions = snapshots;
+        size_t n = sessions.size();
+        size_t blocks = blocksFor(n, pool);
+        sessionCounts.assign(n, StatusCounts());
+        vector<map<string_view, CourseRollup>> blockRollups(blocks);
+        
+        pool.parallelFor(blocks, [&](size_t b) {
+            auto& rollups = blockRollups[b];
+            for (size_t i = n * b / blocks; i < n * (b + 1) / blocks; i++) {
+                sessionCounts[i] = sessions[i]->countStatuses();
+                CourseRollup one;
+                one.sessions = 1;
+                one.counts = sessionCounts[i];
+                one.lowestSession = i;
+                one.lowestRate = one.counts.rate();
+                merge(rollups[sessions[i]->getCourseCode()], one);
+            }
+        });
+        
+        map<string_view, CourseRollup> merged;
+        for (const auto& rollups : blockRollups) {
+            for (const auto& [course, rollup] : rollups) {
+                merge(merged[course], rollup);
+            }
+        }
+        
+        courses.clear();
+        totals = StatusCounts();
+        for (auto& [course, rollup] : merged) {
+            rollup.courseCode = string(course);
+            totals += rollup.counts;
+            courses.push_back(move(rollup));
+        }
+    }
+    
+    const vector<StatusCounts>& getSessionCounts() const { return sessionCounts; }
+    const vector<CourseRollup>& getCourses() const { return courses; }
+    const StatusCounts& getTotals() const { return totals; }
+    
+    // Write the per-session summaries and the course rollups
+    void render(ThreadPool& pool, ReportWriter& out) const {
+        const auto& sessions = snapshots;
+        size_t n = sessions.size();
+        size_t blocks = blocksFor(n, pool);
+        vector<ostringstream> rendered(blocks);
+        
+        pool.parallelFor(blocks, [&](size_t b) {
+            ReportWriter block(rendered[b]);
+            for (size_t i = n * b / blocks; i < n * (b + 1) / blocks; i++) {
+                writeSessionSummary(block, sessions[i]->getCourseCode(), sessions[i]->getDate(),
+                                    sessionCounts[i]);
+            }
+        });
+        for (const auto& text : rendered) {
+            out << text.str();
+        }
+        
+        out << "\nCOURSE ROLLUP:\n";
+        size_t width = 59 + statusColumnsWidth();
+        out.field("Course", 10).field("Sessions", 10).field("Records", 10);
+        writeStatusHeadings(out);
+        out.field("Attended", 10).text("Lowest session\n");
+        out.repeat('-', width).line();
+        for (const auto& course : courses) {
+            const SessionSnapshot& lowest = *sessions[course.lowestSession];
+            out.field(course.courseCode, 10).field(to_string(course.sessions), 10)
+               .field(to_string(course.counts.total()), 10);
+            writeStatusColumns(out, course.counts);
+            char rate[16];
+            snprintf(rate, sizeof(rate), "%.1f%%", course.rate());
+            out.field(rate, 10) << lowest.getDate() << ' ' << lowest.getStartTime() << " (";
+            out.fixed(course.lowestRate, 1).text("%)\n");
+        }
+        out.repeat('-', width).line();
+        out << "All courses: " << totals.total() << " records, ";
+        out.fixed(totals.rate(), 1).text("% attended\n");
+    }
+};
+
+// ==============================
+// 21. SESSION INDEX
+// ==============================
+// Ordered indexes from (course, date, start time) and (date, course, start
+// time) to positions in the caller's session list, so exact lookups and
+// range queries ("EEE227 in February", "everything on 2026-02-10") cost
+// O(log n) plus the number of matches. Dates are YYYY-MM-DD, so a prefix
+// such as "2026-02" selects a month and "2026" a year.
+class SessionIndex {
+private:
+    using Key = tuple<string, string, string>;
+    using KeyView = tuple<string_view, string_view, string_view>;
+    
+    multimap<Key, size_t, less<>> byCourse;
+    multimap<Key, size_t, less<>> byDate;
+    
+    static bool startsWith(const string& str, string_view prefix) {
+        return str.compare(0, prefix.size(), prefix) == 0;
+    }
+    
+public:
+    size_t size() const { return byCourse.size(); }
+    
+    void clear() {
+        byCourse.clear();
+        byDate.clear();
+    }
+    
+    void add(const AttendanceSession& session, size_t pos) {
+        byCourse.emplace(Key(session.getCourseCode(), session.getDate(), session.getStartTime()), pos);
+        byDate.emplace(Key(session.getDate(), session.getCourseCode(), session.getStartTime()), pos);
+    }
+    
+    // Position of the first session added with exactly this key, or -1
+    long find(string_view course, string_view date, string_view startTime) const {
+        auto it = byCourse.find(KeyView(course, date, startTime));
+        return it == byCourse.end() ? -1 : (long)it->second;
+    }
+    
+    // A course's sessions whose date starts with datePrefix, by date and time
+    vector<size_t> inCourse(string_view course, string_view datePrefix = string_view()) const {
+        vector<size_t> result;
+        for (auto it = byCourse.lower_bound(KeyView(course, datePrefix, string_view()));
+             it != byCourse.end(); ++it) {
+            if (get<0>(it->first) != course || !startsWith(get<1>(it->first), datePrefix)) break;
+            result.push_back(it->second);
+        }
+        return result;
+    }
+    
+    // Every session whose date starts with datePrefix, by date, course and time
+    vector<size_t> onDate(string_view datePrefix) const {
+        vector<size_t> result;
+        for (auto it = byDate.lower_bound(KeyView(datePrefix, string_view(), string_view()));
+             it != byDate.end(); ++it) {
+            if (!startsWith(get<0>(it->first), datePrefix)) break;
+            result.push_back(it->second);
+        }
+        return result;
+    }
+};
+
+// ==============================
+// 22. SESSION ARCHIVE
+// ==============================
+// archive_<course>.arc holds every session of one course, oldest first:
+//
+//   char   magic[4] = "DASA", uint16 version
+//   str    course                       (str = varint length + bytes)
+//   varint rosterCount, then each index number front-coded against the
+//          previous one: varint shared prefix, varint suffix length, suffix
+//   varint sessionCount, then per session:
+//     str date, str startTime, varint duration
+//     varint rosterMode: SAME (records as in the previous session),
+//            PREFIX + varint n (the first n roster entries), or
+//            LIST + varint n + n varints (zigzag gaps between positions)
+//     varint changeCount, then changeCount tokens (gap << 4 | code):
+//            skip gap records whose status is unchanged, then set the next
+//            one to code (a status schema ordinal)
+//   uint64 checksum of everything before it
+//
+// A record's status is predicted from that student's status in the
+// previous session that included them (Absent if none), so a week that
+// looks like the last costs a few bytes on top of the shared roster.
+// Version 1 archives, from before the status schema, used 2-bit codes
+// (A = 0, P = 1, L = 2, other = 3) and are still read. The 4-bit code
+// field is part of the format and does not follow the packed lane width.
+
+const char SESSION_ARCHIVE_MAGIC[4] = {'D', 'A', 'S', 'A'};
+const uint16_t SESSION_ARCHIVE_VERSION = 2;
+
+namespace archive {
+
+enum RosterMode : uint64_t { SAME = 0, PREFIX = 1, LIST = 2 };
+
+constexpr unsigned CODE_BITS = 4; // low bits of a change token
+static_assert(statusschema::SLOTS <= (1u << CODE_BITS), "status ordinals must fit a change token");
+
+inline void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += (char)(value | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+inline bool getVarint(const char*& cursor, const char* end, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = (uint8_t)*cursor++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline void putString(string& out, string_view str) {
+    putVarint(out, str.size());
+    out.append(str.data(), str.size());
+}
+
+inline bool getString(const char*& cursor, const char* end, string& str) {
+    uint64_t size;
+    if (!getVarint(cursor, end, size) || size > (uint64_t)(end - cursor)) return false;
+    str.assign(cursor, (size_t)size);
+    cursor += size;
+    return true;
+}
+
+inline uint64_t zigzag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+inline int64_t unzigzag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+} // namespace archive
+
+// Archive filename for a course
+inline string sessionArchiveFilename(const string& courseCode) {
+    return "archive_" + courseCode + ".arc";
+}
+
+// Encode sessions of one course (in the order given, normally by date and
+// time) into the archive format
+inline string encodeSessionArchive(const string& courseCode, const vector<const AttendanceSession*>& sessions) {
+    using namespace archive;
+    METRIC_TIMER(Metric::ArchiveWrite);
+    
+    // Roster: every student in order of first appearance
+    vector<uint32_t> rosterIds;
+    vector<int32_t> rosterPos; // interned id -> roster position, -1 = none
+    vector<vector<uint32_t>> positions(sessions.size());
+    for (size_t s = 0; s < sessions.size(); s++) {
+        const AttendanceSession& session = *sessions[s];
+        positions[s].resize(session.getRecordCount());
+        for (size_t i = 0; i < session.getRecordCount(); i++) {
+            uint32_t id = session.getStudentId(i);
+            if (id >= rosterPos.size()) rosterPos.resize(max<size_t>(id + 1, rosterPos.size() * 2), -1);
+            if (rosterPos[id] == -1) {
+                rosterPos[id] = (int32_t)rosterIds.size();
+                rosterIds.push_back(id);
+            }
+            positions[s][i] = (uint32_t)rosterPos[id];
+        }
+    }
+    
+    string out(SESSION_ARCHIVE_MAGIC, 4);
+    out.append((const char*)&SESSION_ARCHIVE_VERSION, sizeof(SESSION_ARCHIVE_VERSION));
+    putString(out, courseCode);
+    
+    putVarint(out, rosterIds.size());
+    string_view previous;
+    for (uint32_t id : rosterIds) {
+        string_view index = StringInterner::shared()[id];
+        size_t shared = 0;
+        while (shared < index.size() && shared < previous.size() && index[shared] == previous[shared]) shared++;
+        putVarint(out, shared);
+        putString(out, index.substr(shared));
+        previous = index;
+    }
+    
+    putVarint(out, sessions.size());
+    vector<uint8_t> lastCode(rosterIds.size(), statusschema::ordinal(statusschema::DEFAULT_CODE));
+    for (size_t s = 0; s < sessions.size(); s++) {
+        const AttendanceSession& session = *sessions[s];
+        const vector<uint32_t>& pos = positions[s];
+        putString(out, session.getDate());
+        putString(out, session.getStartTime());
+        putVarint(out, (uint32_t)session.getDuration());
+        
+        bool isPrefix = true;
+        for (size_t i = 0; i < pos.size() && isPrefix; i++) isPrefix = pos[i] == i;
+        if (s > 0 && pos == positions[s - 1]) {
+            putVarint(out, SAME);
+        } else if (isPrefix) {
+            putVarint(out, PREFIX);
+            putVarint(out, pos.size());
+        } else {
+            putVarint(out, LIST);
+            putVarint(out, pos.size());
+            int64_t expected = 0;
+            for (uint32_t p : pos) {
+                putVarint(out, zigzag((int64_t)p - expected));
+                expected = (int64_t)p + 1;
+            }
+        }
+        
+        // Changes against each student's previous status
+        string tokens;
+        size_t changes = 0, gap = 0;
+        for (size_t i = 0; i < pos.size(); i++) {
+            uint8_t code = (uint8_t)PackedStatusVector::encode(session.getStatus(i));
+            if (code == lastCode[pos[i]]) {
+                gap++;
+                continue;
+            }
+            putVarint(tokens, (uint64_t)gap << CODE_BITS | code);
+            lastCode[pos[i]] = code;
+            changes++;
+            gap = 0;
+        }
+        putVarint(out, changes);
+        out += tokens;
+    }
+    
+    uint64_t checksum = checksum64(out.data(), out.size());
+    out.append((const char*)&checksum, sizeof(checksum));
+    METRIC_IO(Metric::ArchiveWrite, out.size(), sessions.size());
+    return out;
+}
+
+// Streams sessions out of an archive one at a time. Each next() decodes a
+// session's header and status changes and keeps its status counts up to
+// date (in time proportional to the changes when the roster is the same
+// as the previous session's); records are only materialized by toSession().
+class SessionArchiveReader {
+private:
+    MappedFile file;
+    const char* cursor = nullptr;
+    const char* end = nullptr;
+    string error;
+    
+    string courseCode;
+    vector<uint32_t> rosterIds; // interned index number of each roster entry
+    size_t sessionCount = 0;
+    size_t decoded = 0;
+    
+    // Current session
+    string date, startTime;
+    int duration = 0;
+    vector<uint32_t> positions;
+    vector<uint8_t> lastCode; // per roster entry: status in the latest session including it
+    StatusCounts counts;
+    bool legacyCodes = false; // version 1 archive: 2-bit A/P/L/? codes
+    unsigned codeBits = archive::CODE_BITS;
+    
+    bool fail(const string& message) {
+        error = message;
+        cursor = end;
+        return false;
+    }
+    
+    static void countCode(StatusCounts& c, uint8_t code, int sign) {
+        c[min<size_t>(code, statusschema::UNKNOWN)] += sign;
+    }
+    
+    // Schema ordinal of a token's code
+    uint8_t ordinalOf(uint64_t token) const {
+        static const uint8_t legacy[4] = {
+            statusschema::ordinal('A'), statusschema::ordinal('P'), statusschema::ordinal('L'),
+            statusschema::UNKNOWN,
+        };
+        uint64_t code = token & ((1u << codeBits) - 1);
+        return legacyCodes ? legacy[code] : (uint8_t)code;
+    }
+    
+public:
+    const string& getError() const { return error; }
+    const string& getCourseCode() const { return courseCode; }
+    size_t getSessionCount() const { return sessionCount; }
+    size_t getRosterSize() const { return rosterIds.size(); }
+    
+    const string& getDate() const { return date; }
+    const string& getStartTime() const { return startTime; }
+    int getDuration() const { return duration; }
+    size_t getRecordCount() const { return positions.size(); }
+    const StatusCounts& getCounts() const { return counts; }
+    
+    // Map and verify an archive and read its roster
+    bool open(const string& filename) {
+        using namespace archive;
+        METRIC_TIMER(Metric::ArchiveOpen);
+        if (!file.open(filename)) return fail("Could not open " + filename + "!");
+        
+        const char* data = file.data();
+        size_t size = file.size();
+        uint16_t version;
+        if (size < 4 + sizeof(version) + sizeof(uint64_t) || memcmp(data, SESSION_ARCHIVE_MAGIC, 4) != 0) {
+            return fail("Not a session archive!");
+        }
+        memcpy(&version, data + 4, sizeof(version));
+        if (version != SESSION_ARCHIVE_VERSION && version != 1) {
+            return fail("Unsupported archive version " + to_string(version) + "!");
+        }
+        legacyCodes = version == 1;
+        codeBits = legacyCodes ? 2 : CODE_BITS;
+        uint64_t checksum;
+        memcpy(&checksum, data + size - sizeof(checksum), sizeof(checksum));
+        if (checksum64(data, size - sizeof(checksum)) != checksum) {
+            return fail("Archive checksum mismatch!");
+        }
+        
+        cursor = data + 4 + sizeof(version);
+        end = data + size - sizeof(checksum);
+        uint64_t rosterCount;
+        if (!getString(cursor, end, courseCode) || !getVarint(cursor, end, rosterCount) ||
+            rosterCount > (uint64_t)(end - cursor)) {
+            return fail("Archive is corrupt!");
+        }
+        
+        // Front-coded index numbers, rebuilt into one pool and interned together
+        StringTable indexes;
+        string current;
+        for (uint64_t i = 0; i < rosterCount; i++) {
+            uint64_t shared;
+            string suffix;
+            if (!getVarint(cursor, end, shared) || shared > current.size() || !getString(cursor, end, suffix)) {
+                return fail("Archive is corrupt!");
+            }
+            current.resize((size_t)shared);
+            current += suffix;
+            indexes.push_back(current);
+        }
+        vector<string_view> views(indexes.size());
+        for (size_t i = 0; i < indexes.size(); i++) views[i] = indexes[i];
+        StringInterner::shared().internAll(views, rosterIds);
+        lastCode.assign(rosterIds.size(), statusschema::ordinal(statusschema::DEFAULT_CODE));
+        
+        uint64_t count;
+        if (!getVarint(cursor, end, count)) return fail("Archive is corrupt!");
+        sessionCount = (size_t)count;
+        METRIC_IO(Metric::ArchiveOpen, file.size(), rosterIds.size());
+        decoded = 0;
+        return true;
+    }
+    
+    // Decode the next session; false at the end of the archive or on error
+    // (then getError() is set)
+    bool next() {
+        using namespace archive;
+        if (decoded >= sessionCount) return false;
+        
+        uint64_t value, mode;
+        if (!getString(cursor, end, date) || !getString(cursor, end, startTime) ||
+            !getVarint(cursor, end, value) || !getVarint(cursor, end, mode)) {
+            return fail("Archive is corrupt!");
+        }
+        duration = (int)(uint32_t)value;
+        
+        if (mode == SAME && decoded > 0) {
+            // Same records: counts carry over and only the changes move them
+        } else if (mode == PREFIX || mode == LIST) {
+            uint64_t n;
+            if (!getVarint(cursor, end, n) || n > rosterIds.size()) return fail("Archive is corrupt!");
+            positions.resize((size_t)n);
+            int64_t expected = 0;
+            for (size_t i = 0; i < positions.size(); i++) {
+                int64_t p = (int64_t)i;
+                if (mode == LIST) {
+                    if (!getVarint(cursor, end, value)) return fail("Archive is corrupt!");
+                    p = expected + unzigzag(value);
+                    if (p < 0 || p >= (int64_t)rosterIds.size()) return fail("Archive is corrupt!");
+                    expected = p + 1;
+                }
+                positions[i] = (uint32_t)p;
+            }
+            counts = StatusCounts();
+            for (uint32_t p : positions) countCode(counts, lastCode[p], 1);
+        } else {
+            return fail("Archive is corrupt!");
+        }
+        
+        uint64_t changes;
+        if (!getVarint(cursor, end, changes)) return fail("Archive is corrupt!");
+        size_t record = 0;
+        for (uint64_t c = 0; c < changes; c++) {
+            if (!getVarint(cursor, end, value)) return fail("Archive is corrupt!");
+            record += (size_t)(value >> codeBits);
+            if (record >= positions.size()) return fail("Archive is corrupt!");
+            uint8_t& code = lastCode[positions[record]];
+            countCode(counts, code, -1);
+            code = ordinalOf(value);
+            countCode(counts, code, 1);
+            record++;
+        }
+        
+        decoded++;
+        return true;
+    }
+    
+    // Materialize the current session
+    AttendanceSession toSession() const {
+        AttendanceSession session(courseCode, date, startTime, duration);
+        vector<uint32_t> ids(positions.size());
+        PackedStatusVector statuses;
+        statuses.reserve(positions.size());
+        for (size_t i = 0; i < positions.size(); i++) {
+            ids[i] = rosterIds[positions[i]];
+            statuses.push_back(PackedStatusVector::decode(lastCode[positions[i]]));
+        }
+        session.assignRecords(move(ids), move(statuses));
+        return session;
+    }
+};
+
+// ==============================
+// 23. SESSION CATALOG
+// ==============================
+// Every session file on disk, known by its header alone: course, date,
+// time, duration, file and status counts. Headers are kept in a manifest
+// (sessions.manifest) keyed by file size and modification time, so opening
+// the catalog only stats the files and re-reads the ones that changed.
+// Records are read on demand into an LRU cache bounded by a memory budget;
+// the least recently used sessions are dropped to stay under it, so memory
+// stays flat however much history there is.
+
+struct SessionHeader {
+    string filename;
+    uint64_t fileSize = 0;
+    int64_t modified = 0; // nanoseconds on the filesystem clock
+    string courseCode;
+    string date;
+    string startTime;
+    int duration = 0;
+    StatusCounts counts;
+};
+
+// Size and modification time of a file; false if it cannot be read.
+// Goes through <filesystem>, so it works wherever the rest of the file
+// utilities do (st_mtim is Linux-only).
+inline bool fileSignature(const string& filename, uint64_t& size, int64_t& modified) {
+    error_code ec;
+    uintmax_t bytes = filesystem::file_size(filename, ec);
+    if (ec) return false;
+    filesystem::file_time_type written = filesystem::last_write_time(filename, ec);
+    if (ec) return false;
+    size = (uint64_t)bytes;
+    modified = (int64_t)chrono::duration_cast<chrono::nanoseconds>(written.time_since_epoch()).count();
+    return true;
+}
+
+class SessionCatalog {
+private:
+    struct Entry {
+        SessionHeader header;
+        unique_ptr<AttendanceSession> body; // resident records, if cached
+        size_t bytes = 0;                   // body's share of the budget
+        list<size_t>::iterator lruPos;
+    };
+    
+    vector<Entry> entries;
+    unordered_map<string, size_t> byFilename;
+    list<size_t> lru; // resident entries, most recently used first
+    
+    string manifestFile;
+    size_t budget;
+    size_t residentBytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    
+    static void appendField(string& line, string_view field) {
+        if (field.find_first_of(",\"\n") == string_view::npos) {
+            line += field;
+            return;
+        }
+        line += '"';
+        for (char c : field) {
+            if (c == '"') line += '"';
+            line += c;
+        }
+        line += '"';
+    }
+    
+    template <typename T>
+    static bool parseNumber(string_view field, T& value) {
+        auto result = from_chars(field.data(), field.data() + field.size(), value);
+        return result.ec == errc() && result.ptr == field.data() + field.size();
+    }
+    
+    // Header line of the manifest, with a count column per status
+    static string manifestColumns() {
+        string columns = "filename,size,modified,course,date,time,duration";
+        for (size_t i = 0; i < statusschema::COUNT; i++) {
+            columns += ',';
+            columns += statusschema::STATUSES[i].name;
+        }
+        return columns + ",unknown\n";
+    }
+    
+    // Headers recorded in the manifest, by filename
+    unordered_map<string, SessionHeader> readManifest() const {
+        unordered_map<string, SessionHeader> known;
+        MappedFile file;
+        if (!file.open(manifestFile)) return known;
+        
+        // A manifest written for another status schema has other count
+        // columns; it is ignored and every file is read again
+        string_view text(file.data(), file.size());
+        string columns = manifestColumns();
+        if (text.compare(0, columns.size(), columns) != 0) return known;
+        
+        CsvParser parser(text.substr(columns.size()));
+        vector<string_view> fields;
+        while (parser.nextRow(fields)) {
+            if (fields.size() != 7 + statusschema::SLOTS) continue;
+            SessionHeader h;
+            h.filename = string(fields[0]);
+            h.courseCode = string(fields[3]);
+            h.date = string(fields[4]);
+            h.startTime = string(fields[5]);
+            bool ok = parseNumber(fields[1], h.fileSize) && parseNumber(fields[2], h.modified) &&
+                      parseNumber(fields[6], h.duration);
+            for (size_t i = 0; i < statusschema::SLOTS && ok; i++) {
+                ok = parseNumber(fields[7 + i], h.counts[i]);
+            }
+            if (ok) known[h.filename] = move(h);
+        }
+        return known;
+    }
+    
+    template <typename Session>
+    static void headerFrom(const Session& session, SessionHeader& h) {
+        h.courseCode = session.getCourseCode();
+        h.date = session.getDate();
+        h.startTime = session.getStartTime();
+        h.duration = session.getDuration();
+        h.counts = session.countStatuses();
+    }
+    
+    void evict(size_t pos) {
+        Entry& entry = entries[pos];
+        if (!entry.body) return;
+        residentBytes -= entry.bytes;
+        lru.erase(entry.lruPos);
+        entry.body.reset();
+        entry.bytes = 0;
+    }
+    
+    // Drop least recently used bodies until within budget; the most recent
+    // one always stays
+    void trim() {
+        while (residentBytes > budget && lru.size() > 1) {
+            evict(lru.back());
+            evictions++;
+        }
+    }
+    
+public:
+    static constexpr size_t DEFAULT_BUDGET = 64 << 20;
+    
+    explicit SessionCatalog(size_t budgetBytes = DEFAULT_BUDGET, string manifest = "sessions.manifest")
+        : manifestFile(move(manifest)), budget(budgetBytes) {}
+    
+    size_t size() const { return entries.size(); }
+    const SessionHeader& header(size_t pos) const { return entries[pos].header; }
+    const string& getManifestFile() const { return manifestFile; }
+    
+    size_t getBudget() const { return budget; }
+    size_t getResidentBytes() const { return residentBytes; }
+    size_t getResidentCount() const { return lru.size(); }
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getEvictions() const { return evictions; }
+    
+    void setBudget(size_t budgetBytes) {
+        budget = budgetBytes;
+        trim();
+    }
+    
+    // Match the catalog to the given session files. Headers come from the
+    // manifest where the file is unchanged; other files are read on the pool
+    // for their header and counts, and the manifest is rewritten. Cached
+    // records are dropped. Returns how many files had to be read; files that
+    // could not be read are listed in errors as "<file>: <reason>".
+    size_t refresh(const vector<string>& filenames, ThreadPool& pool, vector<string>& errors) {
+        unordered_map<string, SessionHeader> known = readManifest();
+        
+        lru.clear();
+        residentBytes = 0;
+        entries.clear();
+        byFilename.clear();
+        entries.resize(filenames.size());
+        
+        vector<size_t> stale;
+        for (size_t i = 0; i < filenames.size(); i++) {
+            SessionHeader& h = entries[i].header;
+            h.filename = filenames[i];
+            fileSignature(h.filename, h.fileSize, h.modified);
+            auto it = known.find(h.filename);
+            if (it != known.end() && it->second.fileSize == h.fileSize &&
+                it->second.modified == h.modified) {
+                h = move(it->second);
+            } else {
+                stale.push_back(i);
+            }
+        }
+        
+        vector<string> failures(stale.size());
+        vector<char> ok(stale.size(), 0);
+        const vector<Student> noStudents;
+        pool.parallelFor(stale.size(), [&](size_t i) {
+            AttendanceSession session;
+            ok[i] = session.readFromFile(filenames[stale[i]], noStudents, failures[i]);
+            if (ok[i]) headerFrom(session, entries[stale[i]].header);
+        });
+        
+        // Unreadable files are left out of the catalog
+        vector<Entry> readable;
+        readable.reserve(entries.size());
+        vector<char> failed(entries.size(), 0);
+        for (size_t i = 0; i < stale.size(); i++) {
+            if (!ok[i]) {
+                failed[stale[i]] = 1;
+                errors.push_back(filenames[stale[i]] + ": " + failures[i]);
+            }
+        }
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (failed[i]) continue;
+            byFilename[entries[i].header.filename] = readable.size();
+            readable.push_back(move(entries[i]));
+        }
+        entries = move(readable);
+        
+        if (!stale.empty() || known.size() != entries.size()) saveManifest();
+        return stale.size();
+    }
+    
+    // Record a session version just written to its own file: its header is
+    // taken from memory and its cached records, if any, are dropped.
+    void update(const SessionSnapshot& session) {
+        string filename = session.getFilename();
+        auto it = byFilename.find(filename);
+        size_t pos;
+        if (it == byFilename.end()) {
+            pos = entries.size();
+            entries.push_back(Entry());
+            entries[pos].header.filename = filename;
+            byFilename[filename] = pos;
+        } else {
+            pos = it->second;
+            evict(pos);
+        }
+        SessionHeader& h = entries[pos].header;
+        fileSignature(filename, h.fileSize, h.modified);
+        headerFrom(session, h);
+    }
+    
+    bool saveManifest() const {
+        string text = manifestColumns();
+        for (const auto& entry : entries) {
+            const SessionHeader& h = entry.header;
+            appendField(text, h.filename);
+            text += ',' + to_string(h.fileSize) + ',' + to_string(h.modified) + ',';
+            appendField(text, h.courseCode);
+            text += ',';
+            appendField(text, h.date);
+            text += ',';
+            appendField(text, h.startTime);
+            text += ',' + to_string(h.duration);
+            for (size_t count : h.counts.byOrdinal) text += ',' + to_string(count);
+            text += '\n';
+        }
+        return writeFileAtomically(manifestFile, text);
+    }
+    
+    // Positions of the sessions of a course (all courses if blank) whose
+    // date starts with datePrefix, in date and time order
+    vector<size_t> select(string_view courseCode, string_view datePrefix = "") const {
+        vector<size_t> result;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const SessionHeader& h = entries[i].header;
+            if (!courseCode.empty() && h.courseCode != courseCode) continue;
+            if (h.date.compare(0, datePrefix.size(), datePrefix) != 0) continue;
+            result.push_back(i);
+        }
+        sort(result.begin(), result.end(), [this](size_t a, size_t b) {
+            const SessionHeader& x = entries[a].header;
+            const SessionHeader& y = entries[b].header;
+            return tie(x.date, x.startTime, x.courseCode) < tie(y.date, y.startTime, y.courseCode);
+        });
+        return result;
+    }
+    
+    // Records of a session, read from its file on first use and then cached.
+    // The pointer stays valid until the next load() or refresh(); nullptr on
+    // failure with the reason in error. Sessions whose records match the most
+    // recently used one share its roster.
+    const AttendanceSession* load(size_t pos, const vector<Student>& students, string& error) {
+        Entry& entry = entries[pos];
+        if (entry.body) {
+            hits++;
+            lru.splice(lru.begin(), lru, entry.lruPos);
+            return entry.body.get();
+        }
+        
+        METRIC_TIMER(Metric::CatalogLoad);
+        misses++;
+        auto body = make_unique<AttendanceSession>();
+        if (!body->readFromFile(entry.header.filename, students, error)) return nullptr;
+        if (!lru.empty()) body->shareRoster(entries[lru.front()].body->getRoster());
+        
+        entry.bytes = body->memoryBytes();
+        entry.body = move(body);
+        lru.push_front(pos);
+        entry.lruPos = lru.begin();
+        residentBytes += entry.bytes;
+        trim();
+        return entry.body.get();
+    }
+};
+
+// ==============================
+// 24. CHECK-IN INGESTION
+// ==============================
+// Bulk import of timestamped card-reader scans, one per line:
+//
+//   <index>,<YYYY-MM-DD HH:MM[:SS]>[,<course>]
+//
+// (a 'T' may separate date and time; the course only matters when
+// sessions overlap). The file is mapped and cut into chunks that are
+// parsed and routed in parallel: a scan belongs to the session on its date
+// whose window (earlyMinutes before the start until the end) contains it,
+// and to that student's record. The earliest scan per record wins, so
+// repeat scans drop out, and it is classified Present (up to
+// lateAfterMinutes after the start) or Late. Records with no scan are left
+// as they are (Absent unless marked by hand). Every touched session then
+// gets a single applyStatuses() pass.
+
+struct CheckInPolicy {
+    int earlyMinutes = 30;     // scans this long before the start count
+    int lateAfterMinutes = 10; // scans later than this after the start are Late
+};
+
+struct CheckInStats {
+    size_t scans = 0;          // non-empty lines
+    size_t present = 0;        // records marked Present
+    size_t late = 0;           // records marked Late
+    size_t duplicates = 0;     // repeat scans for an already scanned record
+    size_t unknownStudent = 0; // in a session window, but not on its roster
+    size_t noSession = 0;      // no session open at that time
+    size_t malformed = 0;
+    size_t sessionsTouched = 0;
+    double parseSeconds = 0;
+    double applySeconds = 0;
+    
+    double scansPerSecond() const {
+        double total = parseSeconds + applySeconds;
+        return total > 0 ? (double)scans / total : 0.0;
+    }
+};
+
+// "HH:MM" or "HH:MM:SS" as seconds since midnight
+inline bool parseClockTime(string_view text, int& seconds) {
+    int parts[3] = {0, 0, 0};
+    size_t count = 0, pos = 0;
+    while (count < 3 && pos <= text.size()) {
+        size_t end = text.find(':', pos);
+        if (end == string_view::npos) end = text.size();
+        auto result = from_chars(text.data() + pos, text.data() + end, parts[count]);
+        if (result.ec != errc() || result.ptr != text.data() + end || end == pos) return false;
+        count++;
+        pos = end + 1;
+    }
+    if (count < 2 || pos <= text.size()) return false;
+    if (parts[0] > 23 || parts[1] > 59 || parts[2] > 59) return false;
+    seconds = parts[0] * 3600 + parts[1] * 60 + parts[2];
+    return true;
+}
+
+class CheckInIngestor {
+private:
+    static constexpr size_t CHUNK_BYTES = 1 << 20;
+    
+    // A session's scan window on its date, in seconds since midnight
+    struct Window {
+        size_t session;
+        string_view course;
+        int opens;
+        int starts;
+        int closes;
+    };
+    
+    // A routed scan: record slot of a window, and when it happened
+    struct Scan {
+        uint32_t window;
+        uint32_t slot;
+        int32_t seconds;
+    };
+    
+    struct ChunkResult {
+        vector<Scan> scans;
+        size_t lines = 0;
+        size_t unknownStudent = 0;
+        size_t noSession = 0;
+        size_t malformed = 0;
+    };
+    
+    vector<AttendanceSession>& sessions;
+    ThreadPool& pool;
+    CheckInPolicy policy;
+    
+    vector<Window> windows;
+    unordered_map<string_view, vector<uint32_t>> windowsByDate;
+    
+    void buildWindows() {
+        windows.clear();
+        windowsByDate.clear();
+        for (size_t i = 0; i < sessions.size(); i++) {
+            int start;
+            if (!parseClockTime(sessions[i].getStartTime(), start)) continue;
+            Window w;
+            w.session = i;
+            w.course = sessions[i].getCourseCode();
+            w.starts = start;
+            w.opens = start - policy.earlyMinutes * 60;
+            w.closes = start + sessions[i].getDuration() * 3600;
+            windowsByDate[sessions[i].getDate()].push_back((uint32_t)windows.size());
+            windows.push_back(w);
+        }
+    }
+    
+    // Route one line into result
+    void routeLine(string_view line, ChunkResult& result) const {
+        size_t comma = line.find(',');
+        if (comma == string_view::npos) {
+            result.malformed++;
+            return;
+        }
+        string_view index = trimField(line.substr(0, comma));
+        string_view rest = line.substr(comma + 1);
+        string_view course;
+        size_t comma2 = rest.find(',');
+        if (comma2 != string_view::npos) {
+            course = trimField(rest.substr(comma2 + 1));
+            rest = rest.substr(0, comma2);
+        }
+        rest = trimField(rest);
+        
+        int seconds;
+        if (index.empty() || rest.size() < 16 || (rest[10] != ' ' && rest[10] != 'T') ||
+            !parseClockTime(rest.substr(11), seconds)) {
+            result.malformed++;
+            return;
+        }
+        
+        auto dateWindows = windowsByDate.find(rest.substr(0, 10));
+        if (dateWindows == windowsByDate.end()) {
+            result.noSession++;
+            return;
+        }
+        
+        bool inWindow = false;
+        for (uint32_t w : dateWindows->second) {
+            const Window& window = windows[w];
+            if (seconds < window.opens || seconds >= window.closes) continue;
+            if (!course.empty() && course != window.course) continue;
+            inWindow = true;
+            int slot = sessions[window.session].findRecord(index);
+            if (slot != -1) {
+                result.scans.push_back(Scan{w, (uint32_t)slot, seconds});
+                return;
+            }
+        }
+        if (inWindow) {
+            result.unknownStudent++;
+        } else {
+            result.noSession++;
+        }
+    }
+    
+    void routeChunk(string_view text, ChunkResult& result) const {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == string_view::npos) end = text.size();
+            string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty()) continue;
+            result.lines++;
+            routeLine(line, result);
+        }
+    }
+    
+public:
+    CheckInIngestor(vector<AttendanceSession>& target, ThreadPool& workers,
+                    const CheckInPolicy& rules = CheckInPolicy())
+        : sessions(target), pool(workers), policy(rules) {}
+    
+    // Ingest scans held in memory (e.g. a mapped file)
+    CheckInStats ingest(string_view text) {
+        METRIC_TIMER(Metric::IngestCheckIns);
+        CheckInStats stats;
+        auto started = chrono::steady_clock::now();
+        buildWindows();
+        
+        // Cut at line boundaries roughly every CHUNK_BYTES
+        vector<string_view> chunks;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = min(text.size(), pos + CHUNK_BYTES);
+            if (end < text.size()) {
+                size_t newline = text.find('\n', end);
+                end = newline == string_view::npos ? text.size() : newline + 1;
+            }
+            chunks.push_back(text.substr(pos, end - pos));
+            pos = end;
+        }
+        
+        vector<ChunkResult> results(chunks.size());
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            routeChunk(chunks[i], results[i]);
+        });
+        
+        auto routed = chrono::steady_clock::now();
+        stats.parseSeconds = chrono::duration<double>(routed - started).count();
+        
+        // Earliest scan per record, window by window
+        vector<vector<int32_t>> earliest(windows.size());
+        for (const auto& result : results) {
+            stats.scans += result.lines;
+            stats.unknownStudent += result.unknownStudent;
+            stats.noSession += result.noSession;
+            stats.malformed += result.malformed;
+            for (const Scan& scan : result.scans) {
+                vector<int32_t>& times = earliest[scan.window];
+                if (times.empty()) {
+                    times.assign(sessions[windows[scan.window].session].getRecordCount(), INT32_MAX);
+                }
+                int32_t& t = times[scan.slot];
+                if (t != INT32_MAX) stats.duplicates++;
+                t = min(t, scan.seconds);
+            }
+        }
+        
+        vector<char> marks;
+        for (size_t w = 0; w < windows.size(); w++) {
+            if (earliest[w].empty()) continue;
+            int lateAfter = windows[w].starts + policy.lateAfterMinutes * 60;
+            marks.assign(earliest[w].size(), '\0');
+            for (size_t slot = 0; slot < marks.size(); slot++) {
+                int32_t t = earliest[w][slot];
+                if (t == INT32_MAX) continue;
+                if (t <= lateAfter) {
+                    marks[slot] = 'P';
+                    stats.present++;
+                } else {
+                    marks[slot] = 'L';
+                    stats.late++;
+                }
+            }
+            sessions[windows[w].session].applyStatuses(marks);
+            stats.sessionsTouched++;
+        }
+        
+        stats.applySeconds = chrono::duration<double>(chrono::steady_clock::now() - routed).count();
+        METRIC_IO(Metric::IngestCheckIns, text.size(), stats.scans);
+        return stats;
+    }
+    
+    // Ingest a scan file; false if it cannot be opened
+    bool ingestFile(const string& filename, CheckInStats& stats) {
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        stats = ingest(string_view(file.data(), file.size()));
+        return true;
+    }
+};
+
+// ==============================
+// 25. CHECK-IN NETWORK PROTOCOL
+// ==============================
+// Daemon mode (attendance --daemon) serves check-in terminals over a
+// Unix-domain socket or TCP on localhost. Requests and replies are single
+// lines; clients may pipeline many requests before reading the replies,
+// which come back in order:
+//
+//   OPEN <course> <date> <time> <hours>  -> OK <session> | ERR <reason>
+//                                           (find or create; hours > 0)
+//   MARK <session> <index> <status code> -> OK | ERR <reason>
+//   STATS <session>                      -> OK <count of each status>
+//                                           (P A L E M: schema order)
+//   SAVE                                 -> OK <sessions written>
+//   PING                                 -> OK
+//   METRICS                              -> OK <file>  (Prometheus text written)
+//   QUIT                                 (closes the connection)
+//
+// attendance --loadgen drives a running daemon with pipelined MARKs from
+// several client threads and reports the sustained check-in rate.
+
+struct DaemonOptions {
+    string socketPath;  // Unix-domain socket; empty = TCP
+    int port = 7227;    // TCP port on 127.0.0.1
+    size_t clients = 8;       // --loadgen: concurrent client connections
+    size_t requests = 200000; // --loadgen: total MARK requests
+    size_t pipeline = 64;     // --loadgen: requests in flight per client
+    size_t sessions = 4;      // --loadgen: sessions the clients spread over
+    bool loadSessions = false; // --daemon: load all session files at startup
+    string metricsFile = "attendance.prom"; // --daemon: written on METRICS and at shutdown
+};
+
+// Parse --socket= --port= --clients= --requests= --pipeline= --sessions=
+// --metrics= --load-sessions
+inline bool parseDaemonOptions(int argc, char** argv, DaemonOptions& options) {
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = eq == string::npos ? "" : arg.substr(eq + 1);
+        try {
+            if (key == "--socket") options.socketPath = value;
+            else if (key == "--port") options.port = stoi(value);
+            else if (key == "--clients") options.clients = max<size_t>(1, stoul(value));
+            else if (key == "--requests") options.requests = stoul(value);
+            else if (key == "--pipeline") options.pipeline = max<size_t>(1, stoul(value));
+            else if (key == "--sessions") options.sessions = max<size_t>(1, stoul(value));
+            else if (key == "--metrics" && !value.empty()) options.metricsFile = value;
+            else if (arg == "--load-sessions") options.loadSessions = true;
+            else {
+                cout << "Error: Unknown option " << arg << endl;
+                return false;
+            }
+        } catch (const exception&) {
+            cout << "Error: Invalid value in " << arg << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Splits a string into space-separated words (at most maxWords)
+inline size_t splitWords(string_view line, string_view* words, size_t maxWords) {
+    size_t count = 0, pos = 0;
+    while (count < maxWords) {
+        while (pos < line.size() && line[pos] == ' ') pos++;
+        if (pos >= line.size()) break;
+        size_t end = line.find(' ', pos);
+        if (end == string_view::npos) end = line.size();
+        words[count++] = line.substr(pos, end - pos);
+        pos = end;
+    }
+    return count;
+}
+
+#ifdef ATTENDANCE_POSIX
+// Open a listening socket for the daemon; -1 on failure
+inline int openListener(const DaemonOptions& options) {
+    int fd;
+    if (!options.socketPath.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, options.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(options.socketPath.c_str());
+        if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)options.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, 128) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Connect to a daemon; -1 on failure
+inline int connectToDaemon(const DaemonOptions& options) {
+    int fd;
+    if (!options.socketPath.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, options.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)options.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+    return fd;
+}
+
+inline bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        size -= (size_t)sent;
+    }
+    return true;
+}
+
+// Buffered reader that yields complete lines from a socket
+class SocketLineReader {
+private:
+    int fd;
+    string buffer;
+    size_t consumed = 0;
+    
+public:
+    explicit SocketLineReader(int socketFd) : fd(socketFd) {}
+    
+    // Next complete line already buffered (without reading); false if none
+    bool nextBuffered(string_view& line) {
+        size_t end = buffer.find('\n', consumed);
+        if (end == string::npos) return false;
+        size_t lineEnd = end > consumed && buffer[end - 1] == '\r' ? end - 1 : end;
+        line = string_view(buffer).substr(consumed, lineEnd - consumed);
+        consumed = end + 1;
+        return true;
+    }
+    
+    // Read more data (blocking up to timeoutMs); false on EOF or error
+    bool fill(int timeoutMs, bool& timedOut) {
+        timedOut = false;
+        if (consumed > 0) {
+            buffer.erase(0, consumed);
+            consumed = 0;
+        }
+        pollfd waitFor{fd, POLLIN, 0};
+        int ready = poll(&waitFor, 1, timeoutMs);
+        if (ready == 0) {
+            timedOut = true;
+            return true;
+        }
+        if (ready < 0) return errno == EINTR;
+        
+        char chunk[16384];
+        ssize_t got = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (got <= 0) return false;
+        buffer.append(chunk, (size_t)got);
+        return true;
+    }
+};
+#endif
+
+// Drive a running daemon with pipelined MARK requests from several client
+// threads; prints throughput and batch round-trip latency
+inline int runLoadGenerator(const DaemonOptions& options, const vector<Student>& roster) {
+#ifdef ATTENDANCE_POSIX
+    if (roster.empty()) {
+        cout << "Error: The load generator needs students.txt for index numbers." << endl;
+        return 1;
+    }
+    
+    atomic<size_t> completed{0}, errors{0};
+    vector<vector<double>> latencies(options.clients);
+    vector<thread> threads;
+    atomic<bool> failed{false};
+    size_t perClient = options.requests / options.clients;
+    
+    auto started = chrono::steady_clock::now();
+    for (size_t c = 0; c < options.clients; c++) {
+        threads.emplace_back([&, c] {
+            int fd = connectToDaemon(options);
+            if (fd < 0) {
+                failed = true;
+                return;
+            }
+            SocketLineReader reader(fd);
+            string_view line;
+            bool timedOut;
+            
+            // Each client opens one of the load-test sessions
+            char time[8];
+            snprintf(time, sizeof(time), "%02zu:00", 8 + (c % options.sessions));
+            string open = string("OPEN LOADTEST 2026-01-01 ") + time + " 1\n";
+            if (!sendAll(fd, open.data(), open.size())) {
+                failed = true;
+                ::close(fd);
+                return;
+            }
+            while (!reader.nextBuffered(line)) {
+                if (!reader.fill(5000, timedOut) || timedOut) {
+                    failed = true;
+                    ::close(fd);
+                    return;
+                }
+            }
+            string sessionId(line.substr(line.find(' ') + 1));
+            
+            uint64_t seed = 0x9E3779B97F4A7C15ULL * (c + 1);
+            const char statuses[3] = {'P', 'A', 'L'};
+            string batch;
+            for (size_t sent = 0; sent < perClient;) {
+                size_t count = min(options.pipeline, perClient - sent);
+                batch.clear();
+                for (size_t i = 0; i < count; i++) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 7;
+                    seed ^= seed << 17;
+                    batch += "MARK " + sessionId + " ";
+                    batch += roster[seed % roster.size()].getIndex();
+                    batch += ' ';
+                    batch += statuses[(seed >> 32) % 3];
+                    batch += '\n';
+                }
+                
+                auto batchStart = chrono::steady_clock::now();
+                if (!sendAll(fd, batch.data(), batch.size())) {
+                    failed = true;
+                    break;
+                }
+                size_t replies = 0;
+                while (replies < count) {
+                    if (reader.nextBuffered(line)) {
+                        if (line.compare(0, 2, "OK") != 0) errors++;
+                        replies++;
+                    } else if (!reader.fill(5000, timedOut) || timedOut) {
+                        failed = true;
+                        break;
+                    }
+                }
+                if (failed) break;
+                latencies[c].push_back(
+                    chrono::duration<double, micro>(chrono::steady_clock::now() - batchStart).count());
+                sent += count;
+                completed += count;
+            }
+            
+            sendAll(fd, "QUIT\n", 5);
+            ::close(fd);
+        });
+    }
+    for (auto& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    
+    if (failed) {
+        cout << "Error: Lost connection to the daemon (is it running?)" << endl;
+        if (completed == 0) return 1;
+    }
+    
+    vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+        return all.empty() ? 0.0 : all[min(all.size() - 1, (size_t)(p * all.size()))];
+    };
+    
+    cout << fixed << setprecision(0);
+    cout << "Clients: " << options.clients << ", pipeline: " << options.pipeline 
+         << ", sessions: " << options.sessions << endl;
+    cout << "Check-ins: " << completed << " in " << setprecision(3) << seconds << " s (" 
+         << setprecision(0) << (seconds > 0 ? completed / seconds : 0.0) << " per second)" << endl;
+    cout << "Errors: " << errors << endl;
+    cout << setprecision(1) << "Batch round trip: p50 " << percentile(0.50) << " us, p99 " 
+         << percentile(0.99) << " us" << endl;
+    return failed ? 1 : 0;
+#else
+    (void)options;
+    (void)roster;
+    cout << "Error: The load generator needs a POSIX system." << endl;
+    return 1;
+#endif
+}
 
 // ==============================
-// 2. ATTENDANCE RECORD CLASS
+// 26. AUTOSAVE
 // ==============================
-class AttendanceRecord {
+// Saves changed sessions from a background thread. Without it, data is only
+// written when the operator saves or exits, so a crash loses a morning of
+// marking, and saving every session stalls the menu. The thread wakes at
+// least once a second. It flushes when the interval has passed since the
+// last flush, or sooner once maxChanges session versions have been
+// published. A change is therefore on disk within interval plus one wake
+// period of being published. The flush callback writes snapshots, so
+// marking goes on while it runs.
+
+struct AutosavePolicy {
+    chrono::milliseconds interval{30000};
+    size_t maxChanges = 20; // published versions that force a flush; 0: none
+};
+
+// What one flush did
+struct AutosaveResult {
+    size_t written = 0;
+    size_t failed = 0;
+};
+
+class Autosaver {
 private:
-    string studentIndex;
-    char status; // 'P' = Present, 'A' = Absent, 'L' = Late
-    
-public:
-    AttendanceRecord() : studentIndex(""), status('A') {}
-    
-    AttendanceRecord(string idx, char s) : studentIndex(idx), status(s) {}
+    AutosavePolicy policy;
+    function<AutosaveResult()> flush;
     
-    // Getters
-    string getStudentIndex() const { return studentIndex; }
-    char getStatus() const { return status; }
+    mutex lock;
+    condition_variable wake;
+    bool stopping = false;
+    thread worker;
     
-    // Setters
-    void setStatus(char s) { status = s; }
+    atomic<size_t> flushes{0};
+    atomic<size_t> written{0};
+    atomic<size_t> failed{0};
     
-    // Display record
-    void display(const vector<Student>& students) const {
-        // Find student name
-        string studentName = "Unknown";
-        for (const auto& student : students) {
-            if (student.getIndex() == studentIndex) {
-                studentName = student.getName();
-                break;
-            }
-        }
+    void run() {
+        using Clock = chrono::steady_clock;
+        chrono::milliseconds tick = min(policy.interval, chrono::milliseconds(1000));
+        uint64_t flushedChanges = SessionSnapshot::publishedTotal().load();
+        Clock::time_point lastFlush = Clock::now();
         
-        string statusText;
-        switch (status) {
-            case 'P': statusText = "Present"; break;
-            case 'A': statusText = "Absent"; break;
-            case 'L': statusText = "Late"; break;
-            default: statusText = "Unknown";
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            wake.wait_for(guard, tick);
+            if (stopping) break;
+            
+            uint64_t published = SessionSnapshot::publishedTotal().load();
+            uint64_t changes = published - flushedChanges;
+            Clock::time_point now = Clock::now();
+            if (changes == 0) {
+                // Nothing to lose yet; the window starts at the next change
+                lastFlush = now;
+                continue;
+            }
+            bool due = now - lastFlush >= policy.interval ||
+                       (policy.maxChanges > 0 && changes >= policy.maxChanges);
+            if (!due) continue;
+            
+            guard.unlock();
+            AutosaveResult result;
+            {
+                METRIC_TIMER(Metric::AutosaveFlush);
+                result = flush();
+            }
+            guard.lock();
+            
+            // Versions published during the flush are left for the next one
+            flushedChanges = published;
+            lastFlush = now;
+            flushes++;
+            written += result.written;
+            failed += result.failed;
         }
-        
-        cout << left << setw(15) << studentIndex 
-             << setw(25) << studentName 
-             << setw(10) << statusText << endl;
     }
     
-    // Convert to string for file storage
-    string toString() const {
-        return studentIndex + "," + status;
+public:
+    Autosaver(AutosavePolicy autosavePolicy, function<AutosaveResult()> flushFn)
+        : policy(autosavePolicy), flush(move(flushFn)) {
+        worker = thread([this] { run(); });
     }
     
-    // Load from string
-    static AttendanceRecord fromString(const string& data) {
-        size_t commaPos = data.find(',');
-        if (commaPos != string::npos) {
-            string idx = data.substr(0, commaPos);
-            char status = data.substr(commaPos + 1)[0];
-            return AttendanceRecord(idx, status);
+    ~Autosaver() { stop(); }
+    
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+    
+    // Finish any flush in progress and end the thread
+    void stop() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
         }
-        return AttendanceRecord("", 'A');
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
     }
+    
+    const AutosavePolicy& getPolicy() const { return policy; }
+    size_t flushCount() const { return flushes.load(); }
+    size_t writtenCount() const { return written.load(); }
+    size_t failedCount() const { return failed.load(); }
 };
 
 // ==============================
-// 3. ATTENDANCE SESSION CLASS
+// 27. SYSTEM MANAGER CLASS
 // ==============================
-class AttendanceSession {
+class AttendanceSystem {
 private:
-    string courseCode;
-    string date;
-    string startTime;
-    int duration; // in hours
-    vector<AttendanceRecord> records;
+    StudentRegistry students;
+    vector<AttendanceSession> sessions;
+    SessionIndex sessionIndex; // (course, date, time) -> position in sessions
+    string studentsFile = "students.txt";
     
-public:
-    AttendanceSession() : courseCode(""), date(""), startTime(""), duration(0) {}
+    // Reports are appended here instead of printed when set
+    string reportFile;
     
-    AttendanceSession(string course, string d, string time, int dur) 
-        : courseCode(course), date(d), startTime(time), duration(dur) {}
+    // Default target for Prometheus metrics exports
+    string metricsFile = "attendance.prom";
     
-    // Getters
-    string getCourseCode() const { return courseCode; }
-    string getDate() const { return date; }
-    string getStartTime() const { return startTime; }
-    int getDuration() const { return duration; }
-    vector<AttendanceRecord> getRecords() const { return records; }
+    // Registrations since the last full save of studentsFile; folded back
+    // into the base file once it holds this many entries
+    AppendOnlyLog studentJournal{"students.journal"};
+    static const size_t JOURNAL_COMPACT_THRESHOLD = 1000;
     
-    // Get filename for this session
-    string getFilename() const {
-        // Replace hyphens with underscores for filename
-        string formattedDate = date;
-        replace(formattedDate.begin(), formattedDate.end(), '-', '_');
-        return "session_" + courseCode + "_" + formattedDate + ".txt";
-    }
+    ThreadPool workers;
     
-    // Add a record
-    void addRecord(const AttendanceRecord& record) {
-        records.push_back(record);
-    }
+    // Per-student, per-course totals maintained by the sessions
+    AttendanceAnalytics analytics;
     
-    // Update a record
-    bool updateRecord(string studentIndex, char status) {
-        for (auto& record : records) {
-            if (record.getStudentIndex() == studentIndex) {
-                record.setStatus(status);
-                return true;
-            }
-        }
-        return false;
-    }
+    // Headers of every session file, with records read on demand; opened on
+    // first use
+    SessionCatalog catalog;
+    bool catalogOpen = false;
     
-    // Initialize records for all students
-    void initializeRecords(const vector<Student>& students) {
-        records.clear();
-        for (const auto& student : students) {
-            records.push_back(AttendanceRecord(student.getIndex(), 'A')); // Default: Absent
-        }
-    }
+    // Daemon mode and autosave: sessionsLock guards the sessions vector
+    // itself (exclusive to add sessions, shared while marking or saving);
+    // saveLock lets one save run at a time and guards savedSnapshots;
+    // courseLocks serialize marking within a course. Always taken in that
+    // order: sessionsLock, then saveLock, then a course lock.
+    shared_mutex sessionsLock;
+    array<mutex, 16> courseLocks;
+    mutex saveLock;
     
-    // Display session info
-    void displayHeader() const {
-        cout << "\n==========================================" << endl;
-        cout << "SESSION: " << courseCode << endl;
-        cout << "DATE: " << date << endl;
-        cout << "TIME: " << startTime << " (" << duration << " hours)" << endl;
-        cout << "==========================================" << endl;
+    // Version of each session file known to be on disk, by filename
+    unordered_map<string, SessionSnapshot::Ref> savedSnapshots;
+    
+    // Background saving of changed sessions, when started. Declared last so
+    // it stops before the sessions it reads are destroyed.
+    unique_ptr<Autosaver> autosaver;
+    
+    // Take ownership of a session and start counting it in the analytics.
+    // A loaded session whose records match the registry or the previous
+    // session shares that roster instead of keeping its own copy.
+    void addSession(AttendanceSession session) {
+        unique_lock<shared_mutex> writeGuard(sessionsLock);
+        insertSession(move(session));
     }
     
-    // Display attendance list
-    void displayAttendance(const vector<Student>& students) const {
-        cout << "\nATTENDANCE LIST:\n";
-        cout << left << setw(15) << "Index Number" 
-             << setw(25) << "Student Name" 
-             << setw(10) << "Status" << endl;
-        cout << string(50, '-') << endl;
-        
-        for (const auto& record : records) {
-            record.display(students);
+    // addSession for a caller already holding sessionsLock exclusively. A
+    // clean session is recorded as on disk before the lock is released, so
+    // the autosaver never sees it unrecorded and writes it again.
+    void insertSession(AttendanceSession session) {
+        session.publish();
+        if (!session.isDirty()) {
+            lock_guard<mutex> saveGuard(saveLock);
+            savedSnapshots[session.getFilename()] = session.snapshot();
+        }
+        if (!session.shareRoster(students.roster()) && !sessions.empty()) {
+            session.shareRoster(sessions.back().getRoster());
         }
+        sessions.push_back(move(session));
+        sessions.back().attachAnalytics(&analytics);
+        sessionIndex.add(sessions.back(), sessions.size() - 1);
     }
     
-    // Generate summary statistics
-    void displaySummary(const vector<Student>& students) const {
-        int present = 0, absent = 0, late = 0;
+    // Write every session whose published version is not yet on disk, from
+    // its snapshot and without printing. Runs on the autosave thread while
+    // the menu goes on marking.
+    AutosaveResult flushChangedSessions() {
+        shared_lock<shared_mutex> readGuard(sessionsLock);
+        lock_guard<mutex> saveGuard(saveLock);
         
-        for (const auto& record : records) {
-            switch (record.getStatus()) {
-                case 'P': present++; break;
-                case 'A': absent++; break;
-                case 'L': late++; break;
+        // As with saveAllSessions, the last session with a filename wins
+        vector<SessionSnapshot::Ref> versions;
+        unordered_set<string> filenames;
+        for (size_t i = sessions.size(); i-- > 0;) {
+            SessionSnapshot::Ref version = sessions[i].snapshot();
+            string filename = version->getFilename();
+            if (!filenames.insert(filename).second) continue;
+            auto saved = savedSnapshots.find(filename);
+            if (saved == savedSnapshots.end() || saved->second != version) {
+                versions.push_back(move(version));
             }
         }
+        readGuard.unlock();
         
-        int total = present + absent + late;
-        
-        cout << "\nATTENDANCE SUMMARY:\n";
-        cout << "==========================================" << endl;
-        cout << "Course: " << courseCode << " (" << date << ")\n";
-        cout << "Total Students: " << total << endl;
-        cout << "Present: " << present << " (" 
-             << (total > 0 ? (present * 100 / total) : 0) << "%)" << endl;
-        cout << "Absent: " << absent << " (" 
-             << (total > 0 ? (absent * 100 / total) : 0) << "%)" << endl;
-        cout << "Late: " << late << " (" 
-             << (total > 0 ? (late * 100 / total) : 0) << "%)" << endl;
-        cout << "==========================================" << endl;
+        AutosaveResult result;
+        for (const auto& version : versions) {
+            if (version->writeToFile()) {
+                savedSnapshots[version->getFilename()] = version;
+                result.written++;
+            } else {
+                result.failed++;
+            }
+        }
+        return result;
     }
     
-    // Save session to file
-    bool saveToFile() const {
-        ofstream file(getFilename());
-        if (!file.is_open()) {
-            cout << "Error: Could not save session to file!" << endl;
-            return false;
+    // Ask for a course code that has analytics; nullptr if there is none
+    const CourseAnalytics* promptCourse(string& courseCode) {
+        cout << "Courses with sessions:";
+        for (const auto& entry : analytics.allCourses()) {
+            cout << " " << entry.first;
         }
+        cout << "\nEnter course code: ";
+        getline(cin, courseCode);
         
-        // Save session header
-        file << "COURSE:" << courseCode << endl;
-        file << "DATE:" << date << endl;
-        file << "TIME:" << startTime << endl;
-        file << "DURATION:" << duration << endl;
-        file << "ATTENDANCE_RECORDS:" << endl;
-        
-        // Save each record
-        for (const auto& record : records) {
-            file << record.toString() << endl;
+        const CourseAnalytics* course = analytics.findCourse(courseCode);
+        if (!course) {
+            cout << "No sessions found for course " << courseCode << "." << endl;
         }
-        
-        file.close();
-        cout << "Session saved to: " << getFilename() << endl;
-        return true;
+        return course;
     }
     
-    // Load session from file
-    bool loadFromFile(const string& filename, const vector<Student>& students) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            cout << "Error: Could not load session file!" << endl;
-            return false;
-        }
-        
-        records.clear();
-        string line;
-        bool readingRecords = false;
+    // Print analytics rows for the given student positions in course
+    void displayStudentStats(const CourseAnalytics& course, const vector<size_t>& positions,
+                             ReportWriter& out) const {
+        out.field("Index Number", 15).field("Student Name", 25)
+           .field("Attended", 12).field("Rate", 10).line();
+        out.repeat('-', 62).line();
         
-        while (getline(file, line)) {
-            if (line.empty()) continue;
-            
-            if (line == "ATTENDANCE_RECORDS:") {
-                readingRecords = true;
-                continue;
-            }
-            
-            if (!readingRecords) {
-                // Read session info
-                if (line.find("COURSE:") == 0) {
-                    courseCode = line.substr(7);
-                } else if (line.find("DATE:") == 0) {
-                    date = line.substr(5);
-                } else if (line.find("TIME:") == 0) {
-                    startTime = line.substr(5);
-                } else if (line.find("DURATION:") == 0) {
-                    duration = stoi(line.substr(9));
-                }
-            } else {
-                // Read attendance records
-                AttendanceRecord record = AttendanceRecord::fromString(line);
-                records.push_back(record);
-            }
+        for (size_t pos : positions) {
+            const StudentAttendanceStats& stats = course.statsAt(pos);
+            const Student* student = students.get(course.indexAt(pos));
+            char attended[48];
+            char* end = to_chars(attended, attended + 20, (uint64_t)stats.attended()).ptr;
+            *end++ = '/';
+            end = to_chars(end, attended + sizeof(attended), (uint64_t)stats.rated()).ptr;
+            out.field(course.indexAt(pos), 15)
+               .field(student ? string_view(student->getName()) : string_view("Unknown"), 25)
+               .field(string_view(attended, (size_t)(end - attended)), 12)
+               .fixed(stats.rate(), 1).text("%\n");
         }
-        
-        file.close();
-        
-        // If no records were loaded, initialize with current students
-        if (records.empty()) {
-            initializeRecords(students);
+    }
+    
+    // Write the current metrics in Prometheus text format
+    bool exportMetrics(const string& filename) const {
+        return writeFileAtomically(filename, metricsPrometheusText());
+    }
+    
+    // Start a report: to reportFile if one is set, otherwise to the screen
+    void beginReport(ReportWriter& out) const {
+        if (!reportFile.empty() && !out.openFile(reportFile, true)) {
+            cout << "Error: Could not open " << reportFile << ", printing instead." << endl;
         }
-        
-        cout << "Session loaded from: " << filename << endl;
-        return true;
     }
-};
-
-// ==============================
-// 4. SYSTEM MANAGER CLASS
-// ==============================
-class AttendanceSystem {
-private:
-    vector<Student> students;
-    vector<AttendanceSession> sessions;
-    string studentsFile = "students.txt";
+    
+    // Finish a report started with beginReport
+    void endReport(ReportWriter& out) const {
+        bool toFile = out.isFile();
+        out.close();
+        if (toFile) cout << "Report written to " << reportFile << endl;
+    }
     
 public:
     // Constructor
@@ -310,6 +5148,16 @@ public:
         loadStudents();
     }
     
+    const StudentRegistry& getStudents() const { return students; }
+    
+    // Memory allowed for session records read through the catalog
+    void setCatalogBudget(size_t bytes) { catalog.setBudget(bytes); }
+    
+    // Save changed sessions in the background from now on (interactive mode)
+    void startAutosave(const AutosavePolicy& policy) {
+        autosaver.reset(new Autosaver(policy, [this] { return flushChangedSessions(); }));
+    }
+    
     // ========== STUDENT MANAGEMENT ==========
     
     // Register a new student
@@ -321,21 +5169,26 @@ public:
         getline(cin, index);
         
         // Check if student already exists
-        for (const auto& student : students) {
-            if (student.getIndex() == index) {
-                cout << "Error: Student with index " << index << " already exists!" << endl;
-                return;
-            }
+        if (students.contains(index)) {
+            cout << "Error: Student with index " << index << " already exists!" << endl;
+            return;
         }
         
         cout << "Enter student name: ";
         getline(cin, name);
         
         Student newStudent(index, name);
-        students.push_back(newStudent);
+        students.add(newStudent);
         
         cout << "Student registered successfully!" << endl;
-        saveStudents();
+        
+        // Journal just this registration instead of rewriting the whole file
+        if (!studentJournal.append("ADD," + newStudent.toString())) {
+            cout << "Error: Could not write to " << studentJournal.getFilename() << "!" << endl;
+            saveStudents();
+        } else if (studentJournal.size() >= JOURNAL_COMPACT_THRESHOLD) {
+            saveStudents();
+        }
     }
     
     // View all students
@@ -346,15 +5199,17 @@ public:
             return;
         }
         
-        cout << left << setw(15) << "Index Number" 
-             << setw(25) << "Student Name" << endl;
-        cout << string(40, '-') << endl;
+        ReportWriter out;
+        beginReport(out);
+        out.field("Index Number", 15).field("Student Name", 25).line();
+        out.repeat('-', 40).line();
         
         for (const auto& student : students) {
-            student.display();
+            student.display(out);
         }
         
-        cout << "\nTotal: " << students.size() << " students" << endl;
+        out << "\nTotal: " << students.size() << " students\n";
+        endReport(out);
     }
     
     // Search student by index
@@ -365,20 +5220,160 @@ public:
         cout << "Enter index number to search: ";
         getline(cin, index);
         
-        bool found = false;
-        for (const auto& student : students) {
-            if (student.getIndex() == index) {
-                cout << "\nSTUDENT FOUND:\n";
-                cout << "Index: " << student.getIndex() << endl;
-                cout << "Name: " << student.getName() << endl;
-                found = true;
-                break;
+        const Student* student = students.get(index);
+        if (student) {
+            cout << "\nSTUDENT FOUND:\n";
+            cout << "Index: " << student->getIndex() << endl;
+            cout << "Name: " << student->getName() << endl;
+        } else {
+            cout << "Student with index " << index << " not found." << endl;
+            auto similar = students.searchByName(index, 3);
+            if (!similar.empty()) {
+                cout << "Did you mean:" << endl;
+                for (const auto& [match, share] : similar) {
+                    cout << "  " << match->getIndex() << " - " << match->getName() << endl;
+                }
             }
         }
+    }
+    
+    // Fuzzy search on name and index number, ranked by closeness
+    void searchStudentsByName() const {
+        cout << "\n--- SEARCH STUDENTS BY NAME ---\n";
+        string query;
         
-        if (!found) {
-            cout << "Student with index " << index << " not found." << endl;
+        cout << "Enter name or part of it (e.g. Kwame Mens): ";
+        getline(cin, query);
+        
+        auto matches = students.searchByName(query, 20);
+        if (matches.empty()) {
+            cout << "No students match " << query << "." << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        beginReport(out);
+        out.field("Index Number", 15).field("Student Name", 25).text("Match\n");
+        out.repeat('-', 46).line();
+        for (const auto& [student, share] : matches) {
+            out.field(student->getIndex(), 15).field(student->getName(), 25);
+            out.fixed(share * 100.0, 0).text("%\n");
+        }
+        endReport(out);
+    }
+    
+    // List students whose index number starts with a prefix (e.g. "EE20")
+    void searchStudentsByPrefix() const {
+        cout << "\n--- SEARCH STUDENTS BY INDEX PREFIX ---\n";
+        string prefix;
+        
+        cout << "Enter index prefix: ";
+        getline(cin, prefix);
+        
+        vector<const Student*> matches = students.findByPrefix(prefix);
+        if (matches.empty()) {
+            cout << "No students with index starting " << prefix << "." << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        beginReport(out);
+        out.field("Index Number", 15).field("Student Name", 25).line();
+        out.repeat('-', 40).line();
+        
+        for (const Student* student : matches) {
+            student->display(out);
+        }
+        
+        out << "\nTotal: " << matches.size() << " students\n";
+        endReport(out);
+    }
+    
+    // Bulk-import a roster CSV (e.g. a registry export). The file is
+    // mapped and parsed in place; the index and name columns are found from
+    // a header row when there is one (otherwise the first two columns), and
+    // rows whose index is already registered are skipped.
+    void importRosterCSV() {
+        cout << "\n--- BULK IMPORT ROSTER FROM CSV ---\n";
+        cout << "Enter CSV filename: ";
+        
+        string filename;
+        getline(cin, filename);
+        
+        auto started = chrono::steady_clock::now();
+        
+        MappedFile file;
+        if (!file.open(filename)) {
+            cout << "Error: Could not open CSV file!" << endl;
+            return;
+        }
+        string_view data(file.data(), file.size());
+        
+        CsvParser parser(data);
+        vector<string_view> fields;
+        size_t indexColumn = 0, nameColumn = 1;
+        size_t rows = 0, added = 0, duplicates = 0, malformed = 0;
+        
+        students.reserve(students.size() + CsvParser::estimateRows(data));
+        
+        bool firstRow = true;
+        while (parser.nextRow(fields)) {
+            if (firstRow) {
+                firstRow = false;
+                // Header row: pick columns by name
+                bool isHeader = false;
+                for (size_t i = 0; i < fields.size(); i++) {
+                    string column(trimField(fields[i]));
+                    transform(column.begin(), column.end(), column.begin(), ::tolower);
+                    if (column == "index" || column == "index number" || column == "indexnumber" ||
+                        column == "index_number" || column == "id" || column == "student id") {
+                        indexColumn = i;
+                        isHeader = true;
+                    } else if (column == "name" || column == "student name" || column == "full name") {
+                        nameColumn = i;
+                        isHeader = true;
+                    }
+                }
+                if (isHeader) continue;
+            }
+            
+            rows++;
+            if (fields.size() <= max(indexColumn, nameColumn)) {
+                malformed++;
+                continue;
+            }
+            string_view index = trimField(fields[indexColumn]);
+            string_view name = trimField(fields[nameColumn]);
+            // students.txt is one "index,name" line per student
+            if (index.empty() || index.find_first_of(",\r\n") != string_view::npos) {
+                malformed++;
+                continue;
+            }
+            
+            if (students.contains(index)) {
+                duplicates++;
+            } else {
+                string cleanName(name);
+                replace(cleanName.begin(), cleanName.end(), '\n', ' ');
+                replace(cleanName.begin(), cleanName.end(), '\r', ' ');
+                students.add(Student(string(index), cleanName));
+                added++;
+            }
         }
+        
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        
+        cout << "Imported " << added << " of " << rows << " rows";
+        if (duplicates > 0) cout << ", " << duplicates << " already registered";
+        if (malformed > 0) cout << ", " << malformed << " malformed";
+        cout << "." << endl;
+        cout << fixed << setprecision(3) << "Took " << seconds << " s (" 
+             << setprecision(0) << (seconds > 0 ? rows / seconds : 0.0) << " rows/second)." << endl;
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+        
+        // One compacting save for the whole batch rather than a journal entry per row
+        if (added > 0) saveStudents();
     }
     
     // ========== SESSION MANAGEMENT ==========
@@ -404,15 +5399,27 @@ public:
         cout << "Enter start time (HH:MM): ";
         getline(cin, time);
         
+        if (sessionIndex.find(course, date, time) != -1) {
+            cout << "Error: A session for " << course << " on " << date 
+                 << " at " << time << " already exists!" << endl;
+            return;
+        }
+        long clash = findFileClash(course, date, time);
+        if (clash != -1) {
+            cout << "Error: Session " << clash + 1 << " (" << sessions[clash].getStartTime()
+                 << ") would be saved to the same file!" << endl;
+            return;
+        }
+        
         cout << "Enter duration (hours): ";
         cin >> duration;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
         
         // Create new session
         AttendanceSession newSession(course, date, time, duration);
-        newSession.initializeRecords(students);
+        newSession.initializeRecords(students.roster());
         
-        sessions.push_back(newSession);
+        addSession(newSession);
         
         cout << "\nSession created successfully!" << endl;
         newSession.displayHeader();
@@ -433,6 +5440,38 @@ public:
         }
     }
     
+    // Find sessions by course and/or date (a date prefix such as 2026-02
+    // selects a whole month). Sessions are numbered as in viewAllSessions.
+    void findSessions() const {
+        cout << "\n--- FIND SESSIONS ---\n";
+        string course, date;
+        
+        cout << "Enter course code (blank for all courses): ";
+        getline(cin, course);
+        
+        cout << "Enter date or date prefix, e.g. 2026-02-10 or 2026-02 (blank for all dates): ";
+        getline(cin, date);
+        
+        if (course.empty() && date.empty()) {
+            viewAllSessions();
+            return;
+        }
+        
+        vector<size_t> matches = course.empty() ? sessionIndex.onDate(date)
+                                                : sessionIndex.inCourse(course, date);
+        if (matches.empty()) {
+            cout << "No matching sessions found." << endl;
+            return;
+        }
+        
+        for (size_t pos : matches) {
+            cout << pos + 1 << ". " << sessions[pos].getCourseCode() 
+                 << " - " << sessions[pos].getDate() 
+                 << " (" << sessions[pos].getStartTime() << ")" << endl;
+        }
+        cout << matches.size() << " session(s) found." << endl;
+    }
+    
     // ========== ATTENDANCE MARKING ==========
     
     // Mark attendance for a session
@@ -456,12 +5495,18 @@ public:
         }
         
         AttendanceSession& session = sessions[choice - 1];
+        size_t added = session.extendRoster(students.roster());
+        if (added > 0) {
+            cout << "Added " << added << " students registered since this session was created." << endl;
+        }
         session.displayHeader();
         
         cout << "\nMark attendance for each student:\n";
-        cout << "(P = Present, A = Absent, L = Late)\n" << endl;
+        cout << "(" << statusschema::legend() << ")\n" << endl;
         
-        vector<AttendanceRecord> records = session.getRecords();
+        // Collect every mark first, then apply them to the session in one pass
+        vector<StatusUpdate> updates;
+        updates.reserve(students.size());
         
         for (size_t i = 0; i < students.size(); i++) {
             cout << i + 1 << ". " << students[i].getIndex() 
@@ -472,15 +5517,112 @@ public:
             
             if (!input.empty()) {
                 char status = toupper(input[0]);
-                if (status == 'P' || status == 'A' || status == 'L') {
-                    session.updateRecord(students[i].getIndex(), status);
+                if (AttendanceRecord::isValidStatus(status)) {
+                    updates.push_back(StatusUpdate{string(students[i].getIndex()), status});
                 } else {
                     cout << "  Invalid input. Keeping as Absent." << endl;
                 }
             }
         }
         
-        cout << "\nAttendance marked successfully!" << endl;
+        session.applyUpdates(updates);
+        
+        cout << "\nAttendance marked successfully!" << endl;
+    }
+    
+    // Mark a session from a feed file of "index,status" lines in one batch
+    void importAttendanceMarks() {
+        if (sessions.empty()) {
+            cout << "No sessions available. Please create a session first." << endl;
+            return;
+        }
+        
+        cout << "\n--- IMPORT ATTENDANCE MARKS ---\n";
+        viewAllSessions();
+        
+        int choice;
+        cout << "\nSelect session number: ";
+        cin >> choice;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        
+        if (choice < 1 || choice > (int)sessions.size()) {
+            cout << "Invalid session selection!" << endl;
+            return;
+        }
+        
+        cout << "Enter marks filename (lines of index,status): ";
+        string filename;
+        getline(cin, filename);
+        
+        ifstream file(filename);
+        if (!file.is_open()) {
+            cout << "Error: Could not open marks file!" << endl;
+            return;
+        }
+        
+        vector<StatusUpdate> updates;
+        size_t invalid = 0;
+        string line;
+        
+        while (getline(file, line)) {
+            if (line.empty()) continue;
+            size_t commaPos = line.find(',');
+            char status = commaPos != string::npos && commaPos + 1 < line.size()
+                ? (char)toupper(line[commaPos + 1]) : '\0';
+            if (!AttendanceRecord::isValidStatus(status)) {
+                invalid++;
+                continue;
+            }
+            updates.push_back(StatusUpdate{line.substr(0, commaPos), status});
+        }
+        file.close();
+        
+        vector<string> unmatched;
+        size_t applied = sessions[choice - 1].applyUpdates(updates, &unmatched);
+        
+        cout << "Applied " << applied << " marks." << endl;
+        if (!unmatched.empty()) {
+            cout << "Skipped " << unmatched.size() << " marks for students not in this session." << endl;
+        }
+        if (invalid > 0) {
+            cout << "Skipped " << invalid << " malformed lines." << endl;
+        }
+    }
+    
+    // Mark sessions from a file of timestamped check-in scans
+    bool ingestCheckIns(const string& filename) {
+        CheckInIngestor ingestor(sessions, workers);
+        CheckInStats stats;
+        if (!ingestor.ingestFile(filename, stats)) {
+            cout << "Error: Could not open " << filename << "!" << endl;
+            return false;
+        }
+        
+        cout << "Processed " << stats.scans << " scans in " << fixed << setprecision(1)
+             << (stats.parseSeconds + stats.applySeconds) * 1000 << " ms ("
+             << setprecision(0) << stats.scansPerSecond() << " scans/s)." << endl;
+        cout << "Marked " << stats.present << " Present and " << stats.late << " Late in "
+             << stats.sessionsTouched << " sessions." << endl;
+        if (stats.duplicates > 0) cout << "Ignored " << stats.duplicates << " repeat scans." << endl;
+        if (stats.unknownStudent > 0) {
+            cout << "Skipped " << stats.unknownStudent << " scans for students not in the session." << endl;
+        }
+        if (stats.noSession > 0) cout << "Skipped " << stats.noSession << " scans outside any session." << endl;
+        if (stats.malformed > 0) cout << "Skipped " << stats.malformed << " malformed lines." << endl;
+        return true;
+    }
+    
+    void importCheckInScans() {
+        if (sessions.empty()) {
+            cout << "No sessions available. Please create a session first." << endl;
+            return;
+        }
+        
+        cout << "\n--- IMPORT CHECK-IN SCANS ---\n";
+        cout << "Enter scans filename (lines of index,YYYY-MM-DD HH:MM[,course]): ";
+        string filename;
+        getline(cin, filename);
+        ingestCheckIns(filename);
     }
     
     // ========== REPORTS ==========
@@ -505,9 +5647,13 @@ public:
             return;
         }
         
-        AttendanceSession& session = sessions[choice - 1];
-        session.displayHeader();
-        session.displayAttendance(students);
+        // The list and the summary come from the same version
+        SessionSnapshot::Ref session = sessions[choice - 1].current();
+        ReportWriter out;
+        beginReport(out);
+        session->displayHeader(out);
+        session->displayAttendance(students, out);
+        endReport(out);
         
         cout << "\nGenerate summary? (Y/N): ";
         char response;
@@ -515,7 +5661,9 @@ public:
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
         
         if (toupper(response) == 'Y') {
-            session.displaySummary(students);
+            beginReport(out);
+            session->displaySummary(out);
+            endReport(out);
         }
     }
     
@@ -528,74 +5676,850 @@ public:
         
         cout << "\n--- ATTENDANCE SUMMARY ---\n";
         
-        for (auto& session : sessions) {
-            session.displaySummary(students);
+        ReportWriter out;
+        beginReport(out);
+        {
+            METRIC_TIMER(Metric::ReportSummaryAll);
+            vector<SessionSnapshot::Ref> versions;
+            versions.reserve(sessions.size());
+            for (auto& session : sessions) {
+                versions.push_back(session.current());
+            }
+            SummaryReport report;
+            report.build(move(versions), workers);
+            report.render(workers, out);
+        }
+        endReport(out);
+    }
+    
+    // Students whose attendance across all of a course's sessions is below
+    // a threshold (Late counts as attended)
+    void viewStudentsBelowThreshold() {
+        cout << "\n--- STUDENTS BELOW ATTENDANCE THRESHOLD ---\n";
+        string courseCode;
+        const CourseAnalytics* course = promptCourse(courseCode);
+        if (!course) return;
+        
+        double threshold;
+        cout << "Enter threshold percentage (e.g. 75): ";
+        cin >> threshold;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        
+        vector<size_t> below = course->belowThreshold(threshold);
+        if (below.empty()) {
+            cout << "No students in " << courseCode << " are below " << threshold << "%." << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        beginReport(out);
+        out << "\n" << courseCode << " - below ";
+        out.number(threshold) << "% attendance:\n";
+        displayStudentStats(*course, below, out);
+        out << "\nTotal: " << below.size() << " students\n";
+        endReport(out);
+    }
+    
+    // Students with the best attendance across a course's sessions
+    void viewTopStudents() {
+        cout << "\n--- TOP STUDENTS BY ATTENDANCE ---\n";
+        string courseCode;
+        const CourseAnalytics* course = promptCourse(courseCode);
+        if (!course) return;
+        
+        int count;
+        cout << "How many students to list: ";
+        cin >> count;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        if (count <= 0) return;
+        
+        ReportWriter out;
+        beginReport(out);
+        out << "\n" << courseCode << " - top " << count << " by attendance:\n";
+        displayStudentStats(*course, course->top((size_t)count), out);
+        endReport(out);
+    }
+    
+    // Per-session and course totals streamed from an archive, without
+    // loading its sessions
+    void viewArchiveSummary() {
+        cout << "\n--- ARCHIVE SUMMARY ---\n";
+        cout << "Enter archive filename (e.g., archive_EEE227.arc): ";
+        string filename;
+        getline(cin, filename);
+        
+        SessionArchiveReader reader;
+        if (!reader.open(filename)) {
+            cout << "Error: " << reader.getError() << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        beginReport(out);
+        out << "\nARCHIVE SUMMARY: " << reader.getCourseCode() << " (" << reader.getSessionCount()
+            << " sessions, " << reader.getRosterSize() << " students)\n";
+        size_t width = 39 + statusColumnsWidth();
+        out.field("Date", 12).field("Time", 8).field("Students", 10);
+        writeStatusHeadings(out);
+        out.field("Attended", 9).line();
+        out.repeat('-', width).line();
+        
+        StatusCounts totals;
+        while (reader.next()) {
+            const StatusCounts& counts = reader.getCounts();
+            out.field(reader.getDate(), 12).field(reader.getStartTime(), 8);
+            out.field(to_string(counts.total()), 10);
+            writeStatusColumns(out, counts);
+            out.fixed(counts.rate(), 1).text("%\n");
+            totals += counts;
+        }
+        
+        out.repeat('-', width).line();
+        out << "Course totals: ";
+        writeStatusTotals(out, totals);
+        endReport(out);
+        
+        if (!reader.getError().empty()) {
+            cout << "Error: " << reader.getError() << endl;
+        }
+    }
+    
+    // Catalog every session file (headers only), reading just the files
+    // changed since the manifest was written
+    void openCatalog() {
+        if (catalogOpen) return;
+        auto started = chrono::steady_clock::now();
+        vector<string> errors;
+        size_t read = catalog.refresh(discoverSessionFiles(true), workers, errors);
+        for (const auto& error : errors) {
+            cout << "Error: " << error << endl;
+        }
+        catalogOpen = true;
+        
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started);
+        cout << "Catalogued " << catalog.size() << " sessions in " << elapsed.count() << " ms ("
+             << read << " files read)." << endl;
+    }
+    
+    // Every session on disk, from the catalog's headers alone
+    void viewSessionHistory() {
+        cout << "\n--- SESSION HISTORY ---\n";
+        cout << "Enter course code (blank = all courses): ";
+        string course;
+        getline(cin, course);
+        cout << "Enter date or prefix, e.g. 2026-02 (blank = all dates): ";
+        string datePrefix;
+        getline(cin, datePrefix);
+        
+        openCatalog();
+        vector<size_t> found = catalog.select(course, datePrefix);
+        if (found.empty()) {
+            cout << "No sessions found." << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        beginReport(out);
+        out << "\nSESSION HISTORY (" << found.size() << " sessions)\n";
+        size_t width = 49 + statusColumnsWidth();
+        out.field("Course", 10).field("Date", 12).field("Time", 8).field("Students", 10);
+        writeStatusHeadings(out);
+        out.field("Attended", 9).line();
+        out.repeat('-', width).line();
+        
+        StatusCounts totals;
+        for (size_t pos : found) {
+            const SessionHeader& h = catalog.header(pos);
+            out.field(h.courseCode, 10).field(h.date, 12).field(h.startTime, 8);
+            out.field(to_string(h.counts.total()), 10);
+            writeStatusColumns(out, h.counts);
+            out.fixed(h.counts.rate(), 1).text("%\n");
+            totals += h.counts;
+        }
+        
+        out.repeat('-', width).line();
+        out << "Totals: ";
+        writeStatusTotals(out, totals);
+        endReport(out);
+    }
+    
+    // One student's status in every catalogued session, reading records
+    // through the catalog's cache
+    void viewStudentHistory() {
+        cout << "\n--- STUDENT ATTENDANCE HISTORY ---\n";
+        cout << "Enter student index number: ";
+        string index;
+        getline(cin, index);
+        cout << "Enter course code (blank = all courses): ";
+        string course;
+        getline(cin, course);
+        
+        openCatalog();
+        vector<size_t> found = catalog.select(course);
+        size_t missesBefore = catalog.getMisses();
+        
+        ReportWriter out;
+        beginReport(out);
+        const Student* student = students.get(index);
+        out << "\nATTENDANCE HISTORY: " << index;
+        if (student) out << " (" << student->getName() << ")";
+        out << '\n';
+        out.field("Course", 10).field("Date", 12).field("Time", 8).field("Status", 10).line();
+        out.repeat('-', 40).line();
+        
+        StatusCounts counts;
+        string error;
+        for (size_t pos : found) {
+            const AttendanceSession* session = catalog.load(pos, students.all(), error);
+            if (!session) {
+                cout << "Error: " << catalog.header(pos).filename << ": " << error << endl;
+                continue;
+            }
+            int slot = session->findRecord(index);
+            if (slot == -1) continue;
+            char status = session->getStatus(slot);
+            counts[statusschema::ordinal(status)]++;
+            out.field(session->getCourseCode(), 10).field(session->getDate(), 12)
+               .field(session->getStartTime(), 8).field(AttendanceRecord::statusLabel(status), 10).line();
+        }
+        
+        out.repeat('-', 40).line();
+        out << counts.total() << " sessions: ";
+        writeStatusTotals(out, counts);
+        endReport(out);
+        
+        cout << "Read " << catalog.getMisses() - missesBefore << " session files; "
+             << catalog.getResidentCount() << " sessions cached (";
+        cout << fixed << setprecision(1) << catalog.getResidentBytes() / 1048576.0 << " of "
+             << catalog.getBudget() / 1048576.0 << " MB)." << endl;
+    }
+    
+    // Latency and I/O counters gathered since startup
+    void viewPerformanceMetrics() {
+        ReportWriter out;
+        beginReport(out);
+        dumpMetrics(out);
+        endReport(out);
+    }
+    
+    // Choose where reports go: a filename (appended to, after clearing it
+    // now) or blank for the screen
+    void setReportOutput() {
+        cout << "\n--- REPORT OUTPUT ---\n";
+        cout << "Current: " << (reportFile.empty() ? "screen" : reportFile) << endl;
+        cout << "Enter report filename (blank = screen): ";
+        
+        string filename;
+        getline(cin, filename);
+        if (filename.empty()) {
+            reportFile.clear();
+            cout << "Reports will be printed to the screen." << endl;
+            return;
+        }
+        
+        ReportWriter out;
+        if (!out.openFile(filename)) {
+            cout << "Error: Could not open " << filename << "!" << endl;
+            return;
         }
+        reportFile = filename;
+        cout << "Reports will be written to " << reportFile << endl;
     }
     
     // ========== FILE OPERATIONS ==========
     
     // Save all students to file
+    // The file is replaced atomically, after which the registration journal
+    // is emptied since the base file now contains its entries.
     void saveStudents() {
-        ofstream file(studentsFile);
-        if (!file.is_open()) {
-            cout << "Error: Could not save students to file!" << endl;
-            return;
+        METRIC_TIMER(Metric::SaveStudents);
+        string contents;
+        for (const auto& student : students) {
+            contents += student.toString();
+            contents += '\n';
         }
         
-        for (const auto& student : students) {
-            file << student.toString() << endl;
+        if (!writeFileAtomically(studentsFile, contents)) {
+            cout << "Error: Could not save students to file!" << endl;
+            return;
         }
+        METRIC_IO(Metric::SaveStudents, contents.size(), students.size());
+        studentJournal.reset();
         
-        file.close();
         cout << "Students saved to " << studentsFile << endl;
     }
     
-    // Load students from file
+    // Load students from file, then replay registrations journaled since
     void loadStudents() {
+        METRIC_TIMER(Metric::LoadStudents);
+        students.clear();
+        size_t duplicates = 0;
+        
         ifstream file(studentsFile);
-        if (!file.is_open()) {
+        bool haveBase = file.is_open();
+        if (haveBase) {
+            string line;
+            size_t bytes = 0;
+            while (getline(file, line)) {
+                bytes += line.size() + 1;
+                if (!line.empty()) {
+                    if (!students.add(Student::fromString(line))) {
+                        duplicates++;
+                    }
+                }
+            }
+            file.close();
+            METRIC_IO(Metric::LoadStudents, bytes, students.size());
+        }
+        size_t fromBase = students.size();
+        
+        size_t replayed = studentJournal.replay([this, &duplicates](const string& entry) {
+            if (entry.compare(0, 4, "ADD,") == 0) {
+                if (!students.add(Student::fromString(entry.substr(4)))) {
+                    duplicates++;
+                }
+            }
+        });
+        
+        if (!haveBase && replayed == 0) {
             cout << "No existing student data found. Starting fresh." << endl;
             return;
         }
         
-        students.clear();
-        string line;
-        
-        while (getline(file, line)) {
-            if (!line.empty()) {
-                Student student = Student::fromString(line);
-                students.push_back(student);
-            }
+        cout << "Loaded " << fromBase << " students from " << studentsFile << endl;
+        if (replayed > 0) {
+            cout << "Replayed " << replayed << " registrations from " 
+                 << studentJournal.getFilename() << endl;
+        }
+        if (duplicates > 0) {
+            cout << "Skipped " << duplicates << " duplicate index numbers." << endl;
         }
         
-        file.close();
-        cout << "Loaded " << students.size() << " students from " << studentsFile << endl;
+        if (studentJournal.size() >= JOURNAL_COMPACT_THRESHOLD) {
+            saveStudents();
+        }
     }
     
-    // Save all sessions
-    void saveAllSessions() {
-        for (auto& session : sessions) {
-            session.saveToFile();
+    // Save all sessions that changed since they were last saved or loaded
+    // Files are written atomically, fanned out across the worker pool.
+    // Returns how many sessions were written. With daemon set, marking is
+    // locked out per course while versions are taken, and nothing is
+    // printed (it runs on a client thread).
+    size_t saveAllSessions(bool daemon = false) {
+        shared_lock<shared_mutex> readGuard(sessionsLock);
+        lock_guard<mutex> saveGuard(saveLock);
+        
+        // Sessions sharing a filename (the same course, date and start
+        // time) overwrite each other; as with saving them in order, the
+        // last one wins. Each changed session's current
+        // version is taken as a snapshot, so the files are written without
+        // holding up marking or adding sessions.
+        vector<SessionSnapshot::Ref> versions;
+        unordered_set<string> filenames;
+        size_t unchanged = 0; // clean sessions; shadowed ones are not counted
+        for (size_t i = sessions.size(); i-- > 0;) {
+            if (!filenames.insert(sessions[i].getFilename()).second) continue;
+            unique_lock<mutex> markGuard = markingGuard(sessions[i], daemon);
+            // Written by an earlier save or by the autosaver
+            auto saved = savedSnapshots.find(sessions[i].getFilename());
+            if (saved != savedSnapshots.end() && saved->second == sessions[i].current()) {
+                sessions[i].markSaved(saved->second->getVersion());
+            }
+            if (sessions[i].isDirty()) {
+                versions.push_back(sessions[i].current());
+            } else {
+                unchanged++;
+            }
         }
-        cout << "All sessions saved." << endl;
+        readGuard.unlock();
+        reverse(versions.begin(), versions.end());
+        
+        vector<char> saved(versions.size(), 0);
+        workers.parallelFor(versions.size(), [&](size_t i) {
+            saved[i] = versions[i]->writeToFile();
+        });
+        
+        // Sessions are marked clean through savedSnapshots on the next save,
+        // so the sessions vector is not touched again without its lock
+        size_t savedCount = 0;
+        for (size_t i = 0; i < versions.size(); i++) {
+            if (saved[i]) {
+                savedCount++;
+                savedSnapshots[versions[i]->getFilename()] = versions[i];
+                if (catalogOpen) catalog.update(*versions[i]);
+            } else if (!daemon) {
+                cout << "Error: Could not save session to " 
+                     << versions[i]->getFilename() << "!" << endl;
+            }
+        }
+        
+        if (catalogOpen && savedCount > 0) catalog.saveManifest();
+        if (!daemon) {
+            cout << "Saved " << savedCount << " changed sessions (" 
+                 << unchanged << " unchanged)." << endl;
+            cout << "All sessions saved." << endl;
+        }
+        return savedCount;
     }
     
     // Load a specific session from file
     void loadSessionFromFile() {
         cout << "\n--- LOAD SESSION FROM FILE ---\n";
-        cout << "Enter session filename (e.g., session_EEE227_2026_02_10.txt): ";
+        cout << "Enter session filename (e.g., session_EEE227_2026_02_10_0900.txt or .dat): ";
         
         string filename;
         getline(cin, filename);
         
         AttendanceSession newSession;
-        if (newSession.loadFromFile(filename, students)) {
-            sessions.push_back(newSession);
+        if (newSession.loadFromFile(filename, students.all())) {
+            addSession(newSession);
             cout << "Session loaded successfully!" << endl;
         }
     }
     
+    // Session files in the current directory, sorted by name: every
+    // session_*.txt, plus (if includeBinary) each session_*.dat that has no
+    // text counterpart
+    vector<string> discoverSessionFiles(bool includeBinary) {
+        vector<string> textFiles, binaryFiles;
+        error_code ec;
+        for (const auto& entry : filesystem::directory_iterator(".", ec)) {
+            string name = entry.path().filename().string();
+            if (!entry.is_regular_file(ec) || name.compare(0, 8, "session_") != 0 || name.size() <= 12) {
+                continue;
+            }
+            if (name.compare(name.size() - 4, 4, ".txt") == 0) {
+                textFiles.push_back(name);
+            } else if (includeBinary && name.compare(name.size() - 4, 4, ".dat") == 0) {
+                binaryFiles.push_back(name);
+            }
+        }
+        sort(textFiles.begin(), textFiles.end());
+        
+        vector<string> filenames = textFiles;
+        for (const auto& name : binaryFiles) {
+            string textName = name.substr(0, name.size() - 4) + ".txt";
+            if (!binary_search(textFiles.begin(), textFiles.end(), textName)) {
+                filenames.push_back(name);
+            }
+        }
+        sort(filenames.begin(), filenames.end());
+        return filenames;
+    }
+    
+    // Load every session file in the current directory. Files are parsed in
+    // parallel, then added in filename order so the session list is the
+    // same from run to run. Files that fail to parse are reported and skipped,
+    // as are sessions already loaded (same course, date and start time), so
+    // loading again only adds new files. Where two files hold one session
+    // (e.g. an old-style name next to the current one), the file under the
+    // session's own name is used.
+    size_t loadAllSessions() {
+        auto started = chrono::steady_clock::now();
+        vector<string> filenames = discoverSessionFiles(true);
+        
+        vector<AttendanceSession> loaded(filenames.size());
+        vector<string> errors(filenames.size());
+        vector<char> ok(filenames.size(), 0);
+        const vector<Student>& roster = students.all();
+        workers.parallelFor(filenames.size(), [&](size_t i) {
+            ok[i] = loaded[i].readFromFile(filenames[i], roster, errors[i]);
+        });
+        
+        // The file to use for each session: 0 = its own text file, 1 = its
+        // own binary file, 2 = any other name
+        auto rank = [&](size_t i) {
+            if (filenames[i] == loaded[i].getFilename()) return 0;
+            return filenames[i] == loaded[i].getBinaryFilename() ? 1 : 2;
+        };
+        auto keyOf = [&](size_t i) {
+            return make_tuple(loaded[i].getCourseCode(), loaded[i].getDate(), loaded[i].getStartTime());
+        };
+        map<tuple<string, string, string>, size_t> chosen;
+        for (size_t i = 0; i < filenames.size(); i++) {
+            if (!ok[i]) continue;
+            auto [it, added] = chosen.emplace(keyOf(i), i);
+            if (!added && rank(i) < rank(it->second)) it->second = i;
+        }
+        
+        size_t count = 0, skipped = 0;
+        {
+            unique_lock<shared_mutex> writeGuard(sessionsLock);
+            sessions.reserve(sessions.size() + chosen.size());
+            for (size_t i = 0; i < filenames.size(); i++) {
+                if (!ok[i]) {
+                    cout << "Error: " << filenames[i] << ": " << errors[i] << endl;
+                    continue;
+                }
+                const AttendanceSession& session = loaded[i];
+                if (chosen[keyOf(i)] != i ||
+                    sessionIndex.find(session.getCourseCode(), session.getDate(), session.getStartTime()) != -1) {
+                    skipped++;
+                    continue;
+                }
+                insertSession(move(loaded[i]));
+                count++;
+            }
+        }
+        
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started);
+        cout << "Loaded " << count << " of " << filenames.size() << " session files in "
+             << elapsed.count() << " ms";
+        if (skipped > 0) cout << " (" << skipped << " already loaded)";
+        cout << "." << endl;
+        return count;
+    }
+    
+    // Write every loaded session of a course to archive_<course>.arc
+    void archiveCourseSessions() {
+        cout << "\n--- ARCHIVE COURSE SESSIONS ---\n";
+        cout << "Enter course code: ";
+        string courseCode;
+        getline(cin, courseCode);
+        
+        vector<size_t> matches = sessionIndex.inCourse(courseCode);
+        if (matches.empty()) {
+            cout << "No sessions found for course " << courseCode << "." << endl;
+            return;
+        }
+        
+        vector<const AttendanceSession*> archived;
+        size_t textBytes = 0;
+        for (size_t pos : matches) {
+            archived.push_back(&sessions[pos]);
+            textBytes += sessions[pos].toText().size();
+        }
+        
+        string filename = sessionArchiveFilename(courseCode);
+        string contents = encodeSessionArchive(courseCode, archived);
+        if (!writeFileAtomically(filename, contents)) {
+            cout << "Error: Could not write " << filename << "!" << endl;
+            return;
+        }
+        cout << "Archived " << archived.size() << " sessions to " << filename << ": "
+             << contents.size() << " bytes (" << textBytes << " bytes as text files)." << endl;
+    }
+    
+    // Add the sessions stored in an archive; sessions already loaded (same
+    // course, date and start time) are skipped
+    void loadSessionsFromArchive() {
+        cout << "\n--- LOAD SESSIONS FROM ARCHIVE ---\n";
+        cout << "Enter archive filename (e.g., archive_EEE227.arc): ";
+        string filename;
+        getline(cin, filename);
+        
+        SessionArchiveReader reader;
+        if (!reader.open(filename)) {
+            cout << "Error: " << reader.getError() << endl;
+            return;
+        }
+        
+        size_t added = 0, skipped = 0;
+        while (reader.next()) {
+            if (sessionIndex.find(reader.getCourseCode(), reader.getDate(), reader.getStartTime()) != -1) {
+                skipped++;
+                continue;
+            }
+            addSession(reader.toSession());
+            added++;
+        }
+        if (!reader.getError().empty()) {
+            cout << "Error: " << reader.getError() << endl;
+        }
+        cout << "Loaded " << added << " sessions from " << filename;
+        if (skipped > 0) cout << " (" << skipped << " already loaded)";
+        cout << "." << endl;
+    }
+    
+    // Write the metrics to a Prometheus text file
+    void exportMetricsFile() {
+        cout << "\n--- EXPORT METRICS ---\n";
+        cout << "Enter filename (blank = " << metricsFile << "): ";
+        string filename;
+        getline(cin, filename);
+        if (filename.empty()) filename = metricsFile;
+        
+        if (!exportMetrics(filename)) {
+            cout << "Error: Could not write " << filename << "!" << endl;
+            return;
+        }
+        cout << "Metrics written to " << filename << endl;
+    }
+    
+    // Convert a text session file to the binary format; a blank filename
+    // converts every session_*.txt in the current directory
+    void convertSessionFiles() {
+        cout << "\n--- CONVERT SESSION FILES TO BINARY ---\n";
+        cout << "Enter session filename (blank = all session_*.txt files): ";
+        
+        string filename;
+        getline(cin, filename);
+        
+        vector<string> filenames;
+        if (!filename.empty()) {
+            filenames.push_back(filename);
+        } else {
+            filenames = discoverSessionFiles(false);
+        }
+        
+        size_t converted = 0;
+        for (const auto& name : filenames) {
+            AttendanceSession session;
+            if (session.loadFromFile(name, students.all()) &&
+                session.saveToBinaryFile(name.substr(0, name.size() - 4) + ".dat")) {
+                converted++;
+            }
+        }
+        cout << "Converted " << converted << " of " << filenames.size() << " session files." << endl;
+    }
+    
+    // ========== DAEMON MODE ==========
+    
+    // Stop flag shared with the signal handler
+    static inline atomic<bool> daemonStopRequested{false};
+    
+    static void requestDaemonStop(int) {
+        daemonStopRequested = true;
+    }
+    
+    // Lock stripe guarding marking for a course: sessions of one course
+    // share it (their CourseAnalytics counters are shared too), while
+    // different courses are usually marked in parallel
+    mutex& courseLockFor(const string& courseCode) {
+        return courseLocks[IndexHashTable::hashKey(courseCode) % courseLocks.size()];
+    }
+    
+    // The session's course lock when running as a daemon, otherwise nothing
+    unique_lock<mutex> markingGuard(const AttendanceSession& session, bool daemon) {
+        if (!daemon) return unique_lock<mutex>();
+        return unique_lock<mutex>(courseLockFor(session.getCourseCode()));
+    }
+    
+    // Position of a loaded session that a new session of this course, date
+    // and start time would share a file with (a start time written
+    // differently, e.g. "0900" against "09:00"), or -1. Call with
+    // sessionsLock held.
+    long findFileClash(string_view course, string_view date, string_view startTime) const {
+        string filename = sessionFilename(string(course), string(date), string(startTime));
+        for (size_t pos : sessionIndex.inCourse(course, date)) {
+            if (sessions[pos].getFilename() == filename) return (long)pos;
+        }
+        return -1;
+    }
+    
+    // Session for a 1-based protocol id; call with sessionsLock held
+    AttendanceSession* sessionById(string_view id) {
+        size_t number = 0;
+        for (char c : id) {
+            if (c < '0' || c > '9') return nullptr;
+            number = number * 10 + (size_t)(c - '0');
+        }
+        if (number < 1 || number > sessions.size()) return nullptr;
+        return &sessions[number - 1];
+    }
+    
+    // Apply a run of MARK requests for one session under a single
+    // acquisition of its locks; one reply line per request
+    void handleMarks(const vector<string_view>& lines, size_t first, size_t last, string& replies) {
+        string_view words[4];
+        splitWords(lines[first], words, 4);
+        
+        shared_lock<shared_mutex> readGuard(sessionsLock);
+        AttendanceSession* session = sessionById(words[1]);
+        if (!session) {
+            for (size_t i = first; i < last; i++) replies += "ERR unknown session\n";
+            return;
+        }
+        
+        lock_guard<mutex> markGuard(courseLockFor(session->getCourseCode()));
+        for (size_t i = first; i < last; i++) {
+            size_t n = splitWords(lines[i], words, 4);
+            char status = n == 4 && words[3].size() == 1 ? (char)toupper(words[3][0]) : '\0';
+            if (!AttendanceRecord::isValidStatus(status)) {
+                replies += "ERR bad request\n";
+            } else if (session->updateRecord(words[2], status)) {
+                replies += "OK\n";
+            } else {
+                replies += "ERR unknown student\n";
+            }
+        }
+        // Readers see the whole batch at once
+        session->publish();
+    }
+    
+    // Handle one non-MARK request; returns false when the client quits
+    bool handleCommand(string_view line, string& replies) {
+        string_view words[6];
+        size_t n = splitWords(line, words, 6);
+        string_view command = n > 0 ? words[0] : string_view();
+        
+        if (command == "OPEN" && n == 5) {
+            // Whole hours, at least one
+            int hours = 0;
+            string_view value = words[4];
+            auto parsed = from_chars(value.data(), value.data() + value.size(), hours);
+            if (parsed.ec != errc() || parsed.ptr != value.data() + value.size() || hours <= 0) {
+                replies += "ERR bad duration\n";
+                return true;
+            }
+            
+            unique_lock<shared_mutex> writeGuard(sessionsLock);
+            long existing = sessionIndex.find(words[1], words[2], words[3]);
+            if (existing != -1) {
+                replies += "OK " + to_string(existing + 1) + "\n";
+                return true;
+            }
+            if (findFileClash(words[1], words[2], words[3]) != -1) {
+                replies += "ERR session file in use\n";
+                return true;
+            }
+            if (students.empty()) {
+                replies += "ERR no students registered\n";
+                return true;
+            }
+            AttendanceSession newSession{string(words[1]), string(words[2]), string(words[3]), hours};
+            newSession.initializeRecords(students.roster());
+            insertSession(newSession);
+            replies += "OK " + to_string(sessions.size()) + "\n";
+        } else if (command == "STATS" && n == 2) {
+            shared_lock<shared_mutex> readGuard(sessionsLock);
+            AttendanceSession* session = sessionById(words[1]);
+            if (!session) {
+                replies += "ERR unknown session\n";
+                return true;
+            }
+            // Counted from the published version, without waiting for marking
+            StatusCounts counts = session->snapshot()->countStatuses();
+            replies += "OK";
+            for (size_t i = 0; i < statusschema::COUNT; i++) replies += " " + to_string(counts[i]);
+            replies += "\n";
+        } else if (command == "SAVE" && n == 1) {
+            replies += "OK " + to_string(saveAllSessions(true)) + "\n";
+        } else if (command == "PING" && n == 1) {
+            replies += "OK\n";
+        } else if (command == "METRICS" && n == 1) {
+            replies += exportMetrics(metricsFile) ? "OK " + metricsFile + "\n" : "ERR could not write metrics\n";
+        } else if (command == "QUIT") {
+            return false;
+        } else {
+            replies += "ERR bad request\n";
+        }
+        return true;
+    }
+    
+#ifdef ATTENDANCE_POSIX
+    // Serve one check-in terminal until it quits or the daemon stops.
+    // Everything the client pipelined is handled before replies are sent.
+    void serveClient(int fd) {
+        SocketLineReader reader(fd);
+        vector<string_view> lines;
+        string replies;
+        bool open = true;
+        
+        while (open && !daemonStopRequested) {
+            bool timedOut;
+            if (!reader.fill(200, timedOut)) break;
+            if (timedOut) continue;
+            
+            lines.clear();
+            string_view line;
+            while (reader.nextBuffered(line)) {
+                lines.push_back(line);
+            }
+            
+            replies.clear();
+            for (size_t i = 0; open && i < lines.size();) {
+                string_view words[2];
+                if (splitWords(lines[i], words, 2) == 2 && words[0] == "MARK") {
+                    // Extend the run while requests target the same session
+                    size_t last = i + 1;
+                    string_view next[2];
+                    while (last < lines.size() && splitWords(lines[last], next, 2) == 2 &&
+                           next[0] == "MARK" && next[1] == words[1]) {
+                        last++;
+                    }
+                    handleMarks(lines, i, last, replies);
+                    i = last;
+                } else {
+                    open = handleCommand(lines[i], replies);
+                    i++;
+                }
+            }
+            
+            if (!replies.empty() && !sendAll(fd, replies.data(), replies.size())) break;
+        }
+        ::close(fd);
+    }
+#endif
+    
+    // Serve check-in terminals until SIGINT/SIGTERM, then save and exit
+    int runDaemon(const DaemonOptions& options) {
+#ifdef ATTENDANCE_POSIX
+        metricsFile = options.metricsFile;
+        int listener = openListener(options);
+        if (listener < 0) {
+            cout << "Error: Could not listen on " 
+                 << (options.socketPath.empty() ? "port " + to_string(options.port) : options.socketPath) 
+                 << ": " << strerror(errno) << endl;
+            return 1;
+        }
+        
+        daemonStopRequested = false;
+        signal(SIGINT, requestDaemonStop);
+        signal(SIGTERM, requestDaemonStop);
+        signal(SIGPIPE, SIG_IGN);
+        
+        cout << "Check-in daemon listening on " 
+             << (options.socketPath.empty() ? "127.0.0.1:" + to_string(options.port) : options.socketPath) 
+             << " (Ctrl+C to stop)" << endl;
+        
+        struct Client {
+            thread worker;
+            shared_ptr<atomic<bool>> finished;
+        };
+        vector<Client> clients;
+        
+        while (!daemonStopRequested) {
+            pollfd waitFor{listener, POLLIN, 0};
+            if (poll(&waitFor, 1, 200) > 0) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0) {
+                    auto finished = make_shared<atomic<bool>>(false);
+                    clients.push_back(Client{thread([this, fd, finished] {
+                        serveClient(fd);
+                        *finished = true;
+                    }), finished});
+                }
+            }
+            
+            // Reap terminals that disconnected
+            for (size_t i = 0; i < clients.size();) {
+                if (*clients[i].finished) {
+                    clients[i].worker.join();
+                    clients.erase(clients.begin() + i);
+                } else {
+                    i++;
+                }
+            }
+        }
+        
+        ::close(listener);
+        if (!options.socketPath.empty()) unlink(options.socketPath.c_str());
+        for (auto& client : clients) {
+            client.worker.join();
+        }
+        
+        cout << "\nStopping daemon, saving data...\n";
+        saveAllSessions();
+        if (exportMetrics(metricsFile)) cout << "Metrics written to " << metricsFile << endl;
+        return 0;
+#else
+        (void)options;
+        cout << "Error: Daemon mode needs a POSIX system." << endl;
+        return 1;
+#endif
+    }
+    
     // ========== DEMO MODE ==========
     
     // Add demo data for testing
@@ -603,26 +6527,26 @@ public:
         cout << "\nAdding demo data...\n";
         
         // Add demo students
-        students.push_back(Student("EE2001", "Kwame Mensah"));
-        students.push_back(Student("EE2002", "Ama Boateng"));
-        students.push_back(Student("EE2003", "Kojo Asare"));
-        students.push_back(Student("EE2004", "Esi Ampofo"));
-        students.push_back(Student("EE2005", "Yaw Ofori"));
+        students.add(Student("EE2001", "Kwame Mensah"));
+        students.add(Student("EE2002", "Ama Boateng"));
+        students.add(Student("EE2003", "Kojo Asare"));
+        students.add(Student("EE2004", "Esi Ampofo"));
+        students.add(Student("EE2005", "Yaw Ofori"));
         
         // Add demo session
         AttendanceSession demoSession("EEE227", "2026-02-10", "09:00", 2);
-        demoSession.initializeRecords(students);
+        demoSession.initializeRecords(students.roster());
         demoSession.updateRecord("EE2001", 'P');
         demoSession.updateRecord("EE2002", 'L');
         demoSession.updateRecord("EE2003", 'P');
         demoSession.updateRecord("EE2004", 'A');
         demoSession.updateRecord("EE2005", 'P');
         
-        sessions.push_back(demoSession);
+        addSession(demoSession);
         
         // Save data
         saveStudents();
-        demoSession.saveToFile();
+        saveAllSessions();
         
         cout << "Demo data added successfully!" << endl;
     }
@@ -643,6 +6567,12 @@ public:
         cout << "==========================================" << endl;
         cout << "Registered Students: " << students.size() << endl;
         cout << "Active Sessions: " << sessions.size() << endl;
+        if (autosaver) {
+            cout << "Autosave: every " << autosaver->getPolicy().interval.count() / 1000 << "s ("
+                 << autosaver->writtenCount() << " session writes";
+            if (autosaver->failedCount() > 0) cout << ", " << autosaver->failedCount() << " FAILED";
+            cout << ")" << endl;
+        }
         cout << "==========================================" << endl;
     }
     
@@ -653,6 +6583,9 @@ public:
             cout << "1. Register New Student\n";
             cout << "2. View All Students\n";
             cout << "3. Search Student by Index\n";
+            cout << "4. Search Students by Index Prefix\n";
+            cout << "5. Bulk Import Roster from CSV\n";
+            cout << "6. Search Students by Name\n";
             cout << "0. Back to Main Menu\n";
             cout << "Enter choice: ";
             cin >> choice;
@@ -662,6 +6595,9 @@ public:
                 case 1: registerStudent(); break;
                 case 2: viewAllStudents(); break;
                 case 3: searchStudent(); break;
+                case 4: searchStudentsByPrefix(); break;
+                case 5: importRosterCSV(); break;
+                case 6: searchStudentsByName(); break;
                 case 0: cout << "Returning to main menu...\n"; break;
                 default: cout << "Invalid choice!\n";
             }
@@ -674,6 +6610,7 @@ public:
             cout << "\n--- SESSION MANAGEMENT ---\n";
             cout << "1. Create New Lecture Session\n";
             cout << "2. View All Sessions\n";
+            cout << "3. Find Sessions by Course/Date\n";
             cout << "0. Back to Main Menu\n";
             cout << "Enter choice: ";
             cin >> choice;
@@ -682,6 +6619,7 @@ public:
             switch (choice) {
                 case 1: createSession(); break;
                 case 2: viewAllSessions(); break;
+                case 3: findSessions(); break;
                 case 0: cout << "Returning to main menu...\n"; break;
                 default: cout << "Invalid choice!\n";
             }
@@ -694,6 +6632,13 @@ public:
             cout << "\n--- REPORTS AND SUMMARY ---\n";
             cout << "1. View Attendance Report for Session\n";
             cout << "2. View Attendance Summary\n";
+            cout << "3. Students Below Attendance Threshold\n";
+            cout << "4. Top Students by Attendance\n";
+            cout << "5. Set Report Output File\n";
+            cout << "6. Summary from Session Archive\n";
+            cout << "7. Performance Metrics\n";
+            cout << "8. Session History (All Session Files)\n";
+            cout << "9. Student Attendance History\n";
             cout << "0. Back to Main Menu\n";
             cout << "Enter choice: ";
             cin >> choice;
@@ -702,6 +6647,13 @@ public:
             switch (choice) {
                 case 1: viewAttendanceReport(); break;
                 case 2: viewAttendanceSummary(); break;
+                case 3: viewStudentsBelowThreshold(); break;
+                case 4: viewTopStudents(); break;
+                case 5: setReportOutput(); break;
+                case 6: viewArchiveSummary(); break;
+                case 7: viewPerformanceMetrics(); break;
+                case 8: viewSessionHistory(); break;
+                case 9: viewStudentHistory(); break;
                 case 0: cout << "Returning to main menu...\n"; break;
                 default: cout << "Invalid choice!\n";
             }
@@ -715,6 +6667,13 @@ public:
             cout << "1. Save All Students to File\n";
             cout << "2. Save All Sessions to Files\n";
             cout << "3. Load Session from File\n";
+            cout << "4. Import Attendance Marks from File\n";
+            cout << "5. Convert Session Files to Binary\n";
+            cout << "6. Load All Session Files\n";
+            cout << "7. Archive Sessions of a Course\n";
+            cout << "8. Load Sessions from Archive\n";
+            cout << "9. Export Metrics (Prometheus)\n";
+            cout << "10. Import Check-in Scans\n";
             cout << "0. Back to Main Menu\n";
             cout << "Enter choice: ";
             cin >> choice;
@@ -724,6 +6683,13 @@ public:
                 case 1: saveStudents(); break;
                 case 2: saveAllSessions(); break;
                 case 3: loadSessionFromFile(); break;
+                case 4: importAttendanceMarks(); break;
+                case 5: convertSessionFiles(); break;
+                case 6: loadAllSessions(); break;
+                case 7: archiveCourseSessions(); break;
+                case 8: loadSessionsFromArchive(); break;
+                case 9: exportMetricsFile(); break;
+                case 10: importCheckInScans(); break;
                 case 0: cout << "Returning to main menu...\n"; break;
                 default: cout << "Invalid choice!\n";
             }
@@ -748,6 +6714,7 @@ public:
                 case 5: fileOperationsMenu(); break;
                 case 6: addDemoData(); break;
                 case 0: 
+                    if (autosaver) autosaver->stop();
                     cout << "\nSaving data before exit...\n";
                     saveStudents();
                     saveAllSessions();
@@ -762,9 +6729,31 @@ public:
 };
 
 // ==============================
-// 5. MAIN FUNCTION
+// 28. MAIN FUNCTION
 // ==============================
-int main() {
+// benchmark.cpp includes this file with ATTENDANCE_NO_MAIN defined
+#ifndef ATTENDANCE_NO_MAIN
+int runMain(int argc, char** argv) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--daemon" || mode == "--loadgen") {
+        DaemonOptions options;
+        if (!parseDaemonOptions(argc, argv, options)) return 1;
+        
+        AttendanceSystem system;
+        if (options.loadSessions) system.loadAllSessions();
+        if (mode == "--daemon") return system.runDaemon(options);
+        return runLoadGenerator(options, system.getStudents().all());
+    }
+    
+    // attendance --ingest=<file>: mark the saved sessions from a scan file
+    if (mode.rfind("--ingest=", 0) == 0) {
+        AttendanceSystem system;
+        system.loadAllSessions();
+        if (!system.ingestCheckIns(mode.substr(9))) return 1;
+        system.saveAllSessions();
+        return 0;
+    }
+    
     cout << "==========================================" << endl;
     cout << "  DIGITAL ATTENDANCE SYSTEM - EEE227" << endl;
     cout << "      Midterm Capstone Project" << endl;
@@ -772,7 +6761,41 @@ int main() {
     cout << "Programme: HND Electrical Engineering (L200)\n" << endl;
     
     AttendanceSystem system;
+    AutosavePolicy autosave;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t megabytes, seconds;
+        if (arg == "--load-sessions") {
+            system.loadAllSessions();
+        } else if (arg.rfind("--cache-mb=", 0) == 0 &&
+                   from_chars(arg.data() + 11, arg.data() + arg.size(), megabytes).ec == errc()) {
+            system.setCatalogBudget(megabytes << 20);
+        } else if (arg.rfind("--autosave=", 0) == 0 &&
+                   from_chars(arg.data() + 11, arg.data() + arg.size(), seconds).ec == errc()) {
+            autosave.interval = chrono::seconds(seconds);
+        } else if (arg.rfind("--autosave-changes=", 0) == 0 &&
+                   from_chars(arg.data() + 19, arg.data() + arg.size(), autosave.maxChanges).ec == errc()) {
+            continue;
+        } else {
+            cout << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+    // --autosave=0 turns background saving off
+    if (autosave.interval.count() > 0) system.startAutosave(autosave);
     system.run();
     
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv) {
+    // Errors that cannot be handled where they happen (e.g. the string
+    // interner running out of ids) end the program with their reason
+    try {
+        return runMain(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Fatal error: " << e.what() << endl;
+        return 1;
+    }
+}
+#endif
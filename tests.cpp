@@ -0,0 +1,1616 @@
+// ==============================
+// DIGITAL ATTENDANCE SYSTEM - TESTS
+// ==============================
+// Behaviour tests for main.cpp. Every test runs in its own scratch
+// directory, with cin fed from a script where it drives the menus and cout
+// captured so it can be checked. A failed check prints where it failed;
+// the run then exits with status 1.
+//
+//   ./tests [name...]     run every test, or only those whose name
+//                         contains one of the arguments
+#define ATTENDANCE_NO_MAIN
+#include "main.cpp"
+
+#include <random>
+#include <set>
+#include <sstream>
+
+static size_t checksFailed = 0;
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            checksFailed++;                                                    \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << endl; \
+        }                                                                      \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                             \
+    do {                                                                       \
+        auto actualValue = (actual);                                           \
+        auto expectedValue = (expected);                                       \
+        if (!(actualValue == expectedValue)) {                                 \
+            checksFailed++;                                                    \
+            cerr << __FILE__ << ":" << __LINE__ << ": " #actual " is " << actualValue \
+                 << ", expected " << expectedValue << endl;                    \
+        }                                                                      \
+    } while (0)
+
+// Tests register themselves here from static initializers
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+static vector<TestCase>& testCases() {
+    static vector<TestCase> cases;
+    return cases;
+}
+
+struct TestRegistration {
+    TestRegistration(const char* name, void (*run)()) { testCases().push_back({name, run}); }
+};
+
+#define TEST(name)                                                             \
+    static void test_##name();                                                 \
+    static TestRegistration register_##name(#name, test_##name);               \
+    static void test_##name()
+
+// Feeds cin from a script and collects everything written to cout, for as
+// long as it is in scope
+class Console {
+private:
+    istringstream input;
+    ostringstream output;
+    streambuf* savedIn;
+    streambuf* savedOut;
+
+public:
+    explicit Console(const string& script = "") : input(script) {
+        savedIn = cin.rdbuf(input.rdbuf());
+        savedOut = cout.rdbuf(output.rdbuf());
+    }
+
+    ~Console() {
+        cin.rdbuf(savedIn);
+        cout.rdbuf(savedOut);
+    }
+
+    string text() const { return output.str(); }
+    bool printed(const string& fragment) const { return output.str().find(fragment) != string::npos; }
+};
+
+inline string readFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+inline void writeFile(const string& filename, const string& contents) {
+    ofstream(filename, ios::binary) << contents;
+}
+
+// ----- String interner -----
+
+TEST(interner_ids) {
+    StringInterner interner;
+    CHECK_EQ(interner.size(), (size_t)1); // id 0 is the empty string
+    CHECK_EQ(interner.intern(""), 0u);
+    CHECK_EQ(interner.find("EE2001"), StringInterner::NOT_FOUND);
+    uint32_t first = interner.intern("EE2001");
+    CHECK_EQ(first, 1u);
+    CHECK_EQ(interner.intern("EE2001"), first);
+    CHECK_EQ(interner.find("EE2001"), first);
+    string_view firstText = interner[first];
+
+    // Past one block of ids and one chunk of characters, strings keep
+    // their ids and their text stays where it was
+    vector<string_view> batch;
+    vector<string> texts;
+    for (int i = 0; i < 70000; i++) texts.push_back("Student Name " + to_string(i));
+    for (const string& text : texts) batch.push_back(text);
+    batch.push_back("EE2001");
+    batch.push_back(texts[5]);
+    vector<uint32_t> ids;
+    interner.internAll(batch, ids);
+    CHECK_EQ(interner.size(), texts.size() + 2);
+    CHECK_EQ(ids[texts.size()], first);
+    CHECK_EQ(ids[texts.size() + 1], ids[5]);
+    for (size_t i = 0; i < texts.size(); i++) {
+        if (ids[i] != i + 2 || interner[ids[i]] != texts[i]) {
+            CHECK_EQ(ids[i], (uint32_t)(i + 2));
+            CHECK_EQ(interner[ids[i]], string_view(texts[i]));
+            break;
+        }
+    }
+    CHECK(firstText.data() == interner[first].data());
+    CHECK_EQ(firstText, string_view("EE2001"));
+
+    // A string longer than a chunk
+    string huge(3 << 20, 'z');
+    uint32_t hugeId = interner.intern(huge);
+    CHECK(interner[hugeId] == huge);
+    CHECK_EQ(interner.intern("after"), hugeId + 1);
+
+    // Threads interning the same strings agree on their ids
+    vector<vector<uint32_t>> seen(4);
+    vector<thread> threads;
+    for (size_t t = 0; t < seen.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; i++) seen[t].push_back(interner.intern("shared " + to_string(i)));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (size_t t = 1; t < seen.size(); t++) CHECK(seen[t] == seen[0]);
+    CHECK_EQ(interner.size(), texts.size() + 4 + 2000);
+
+    // Students hold ids into the shared interner
+    Student student("EE2001", "Kwame Mensah");
+    CHECK_EQ(StringInterner::shared().find("EE2001"), student.getIndexId());
+    CHECK_EQ(StringInterner::shared()[student.getNameId()], string_view("Kwame Mensah"));
+}
+
+// ----- Student registry and registration journal -----
+
+TEST(registry_lookup) {
+    StudentRegistry registry;
+    CHECK(registry.add(Student("EE2003", "Kojo Asare")));
+    CHECK(registry.add(Student("EE2001", "Kwame Mensah")));
+    CHECK(registry.add(Student("EE1001", "Ama Boateng")));
+    CHECK(!registry.add(Student("EE2001", "Someone Else")));
+    CHECK_EQ(registry.size(), (size_t)3);
+
+    CHECK_EQ(registry.find("EE2001"), 1);
+    CHECK_EQ(registry.find("EE9999"), -1);
+    CHECK(registry.get("EE2001") && registry.get("EE2001")->getName() == "Kwame Mensah");
+    CHECK(registry.get("EE9999") == nullptr);
+
+    vector<const Student*> prefixed = registry.findByPrefix("EE2");
+    CHECK_EQ(prefixed.size(), (size_t)2);
+    CHECK(prefixed.size() == 2 && prefixed[0]->getIndex() == "EE2001" && prefixed[1]->getIndex() == "EE2003");
+
+    // The sorted index catches up with students added after a lookup
+    CHECK(registry.add(Student("EE2002", "Esi Ampofo")));
+    vector<const Student*> range = registry.findRange("EE2001", "EE2003");
+    CHECK(range.size() == 2 && range[0]->getIndex() == "EE2001" && range[1]->getIndex() == "EE2002");
+}
+
+TEST(name_search_ranks_best_first) {
+    StudentRegistry registry;
+    CHECK(registry.add(Student("EE3005", "Kofi Boateng")));
+    CHECK(registry.add(Student("EE2002", "Kwame Asante")));
+    CHECK(registry.add(Student("EE2001", "Kwame Mensah")));
+    CHECK(registry.add(Student("EE1001", "Ama Mensah")));
+    CHECK(registry.add(Student("EE3003", "Kofi Boatenk")));
+    CHECK(registry.add(Student("EE3001", "Kofi Boateng")));
+    for (int i = 0; i < 200; i++) {
+        char index[16];
+        snprintf(index, sizeof(index), "CE%04d", i);
+        CHECK(registry.add(Student(index, "Student " + to_string(i))));
+    }
+
+    auto ranked = [](const vector<pair<const Student*, double>>& matches) {
+        for (size_t i = 1; i < matches.size(); i++) {
+            if (matches[i].second > matches[i - 1].second) return false;
+        }
+        return true;
+    };
+
+    // A partial name matches in full and beats a name sharing one word
+    auto partial = registry.searchByName("kwame mens", 10);
+    CHECK(partial.size() >= 2 && ranked(partial));
+    CHECK(partial.size() >= 2 && partial[0].first->getIndex() == "EE2001" && partial[0].second == 1.0);
+    CHECK(partial.size() >= 2 && partial[1].first->getIndex() == "EE2002" && partial[1].second < 1.0);
+
+    // A misspelled one still finds the right student first
+    auto misspelled = registry.searchByName("Kwame Mesnah", 10);
+    CHECK(!misspelled.empty() && ranked(misspelled));
+    CHECK(!misspelled.empty() && misspelled[0].first->getIndex() == "EE2001");
+    CHECK(!misspelled.empty() && misspelled[0].second < 1.0);
+
+    // Students with the same name tie, and come in registration order
+    auto same = registry.searchByName("Kofi Boateng", 10);
+    CHECK(same.size() >= 2 && same[0].first->getIndex() == "EE3005" && same[1].first->getIndex() == "EE3001");
+    CHECK(same.size() >= 2 && same[0].second == same[1].second);
+    CHECK_EQ(registry.searchByName("Kofi Boateng", 1).size(), (size_t)1);
+    // So do students of different names that rank alike
+    auto alike = registry.searchByName("Kofi Boaten", 10);
+    CHECK(alike.size() >= 3 && alike[0].second == alike[2].second);
+    CHECK(alike.size() >= 3 && alike[0].first->getIndex() == "EE3005" &&
+          alike[1].first->getIndex() == "EE3003" && alike[2].first->getIndex() == "EE3001");
+
+    // Index numbers are searched too, and students added later are found
+    auto byIndex = registry.searchByName("EE2001", 5);
+    CHECK(!byIndex.empty() && byIndex[0].first->getIndex() == "EE2001");
+    CHECK(registry.add(Student("EE4001", "Yaw Frimpong")));
+    auto added = registry.searchByName("Frimpong", 5);
+    CHECK(!added.empty() && added[0].first->getIndex() == "EE4001");
+    CHECK(registry.searchByName("Xoxoxo", 5).empty());
+}
+
+TEST(registry_lookups_past_resizes) {
+    // Index numbers of several departments, registered in scrambled order
+    // and without reserve(), so the hash table grows from its initial 16
+    // slots many times and the sorted index merges in batch after batch
+    vector<string> indexes;
+    for (const char* department : {"CE", "EE", "ME"}) {
+        for (int i = 0; i < 1000; i++) {
+            char index[16];
+            snprintf(index, sizeof(index), "%s%04d", department, 1000 + i * 7);
+            indexes.push_back(index);
+        }
+    }
+    mt19937 rng(2026);
+    shuffle(indexes.begin(), indexes.end(), rng);
+
+    StudentRegistry registry;
+    set<string> expected;
+    auto sameStudents = [](const vector<const Student*>& found, set<string>::iterator first,
+                           set<string>::iterator last) {
+        for (const Student* student : found) {
+            if (first == last || student->getIndex() != *first) return false;
+            ++first;
+        }
+        return first == last;
+    };
+    for (size_t i = 0; i < indexes.size(); i++) {
+        CHECK(registry.add(Student(indexes[i], "Student " + to_string(i))));
+        expected.insert(indexes[i]);
+        // Lookups between growth steps, whatever has been sorted so far
+        if (i % 97 == 0 || (i & (i + 1)) == 0) {
+            CHECK(sameStudents(registry.findByPrefix("EE1"), expected.lower_bound("EE1"),
+                               expected.lower_bound("EE2")));
+            CHECK(sameStudents(registry.findRange("CE3000", "EE1500"), expected.lower_bound("CE3000"),
+                               expected.lower_bound("EE1500")));
+        }
+    }
+    CHECK_EQ(registry.size(), indexes.size());
+
+    for (size_t i = 0; i < indexes.size(); i++) {
+        CHECK_EQ(registry.find(indexes[i]), (int)i);
+        CHECK(!registry.add(Student(indexes[i], "Duplicate")));
+    }
+    CHECK_EQ(registry.find("EE1001"), -1);
+    CHECK_EQ(registry.find("EE"), -1);
+    CHECK_EQ(registry.size(), indexes.size());
+
+    CHECK_EQ(registry.findByPrefix("ME").size(), (size_t)1000);
+    CHECK_EQ(registry.findByPrefix("").size(), indexes.size());
+    CHECK(registry.findByPrefix("XX").empty());
+    CHECK(sameStudents(registry.findRange("EE2000", "ME2000"), expected.lower_bound("EE2000"),
+                       expected.lower_bound("ME2000")));
+    CHECK(registry.findRange("EE5000", "EE5000").empty());
+}
+
+TEST(journal_replays_registrations) {
+    {
+        Console console("EE2001\nKwame Mensah\nEE2002\nAma Boateng\n");
+        AttendanceSystem system;
+        system.registerStudent();
+        system.registerStudent();
+    }
+    // Nothing but the journal was written
+    CHECK(!filesystem::exists("students.txt"));
+    CHECK_EQ(readFile("students.journal"), string("ADD,EE2001,Kwame Mensah\nADD,EE2002,Ama Boateng\n"));
+
+    Console console;
+    AttendanceSystem system;
+    CHECK(console.printed("Replayed 2 registrations"));
+    CHECK_EQ(system.getStudents().size(), (size_t)2);
+    CHECK(system.getStudents().contains("EE2002"));
+}
+
+TEST(journal_replays_over_base_file) {
+    writeFile("students.txt", "EE2001,Kwame Mensah\nEE2002,Ama Boateng\n");
+    // A duplicate entry and a torn last line, as left by a crash mid-append
+    writeFile("students.journal", "ADD,EE2003,Kojo Asare\nADD,EE2001,Kwame Mensah\nADD,EE20");
+
+    {
+        Console console;
+        AttendanceSystem system;
+        CHECK(console.printed("Loaded 2 students"));
+        CHECK(console.printed("Replayed 2 registrations"));
+        CHECK(console.printed("Skipped 1 duplicate"));
+        CHECK_EQ(system.getStudents().size(), (size_t)3);
+        CHECK(!system.getStudents().contains("EE20"));
+    }
+    // The torn tail is cut off, so the next append starts a fresh line
+    CHECK_EQ(readFile("students.journal"), string("ADD,EE2003,Kojo Asare\nADD,EE2001,Kwame Mensah\n"));
+
+    {
+        Console console("EE2004\nEsi Ampofo\n");
+        AttendanceSystem system;
+        system.registerStudent();
+        system.saveStudents();
+    }
+    // A full save folds the journal into the base file
+    CHECK_EQ(readFile("students.journal"), string());
+    CHECK_EQ(readFile("students.txt"),
+             string("EE2001,Kwame Mensah\nEE2002,Ama Boateng\nEE2003,Kojo Asare\nEE2004,Esi Ampofo\n"));
+
+    Console console;
+    AttendanceSystem system;
+    CHECK_EQ(system.getStudents().size(), (size_t)4);
+}
+
+// ----- Status counting kernels -----
+
+// Every count kernel the running CPU can execute, by name
+inline vector<pair<string, statuskernels::CountKernel>> availableKernels() {
+    vector<pair<string, statuskernels::CountKernel>> kernels = {{"scalar", statuskernels::countPortable}};
+#ifdef ATTENDANCE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")) kernels.push_back({"ssse3", statuskernels::countSSSE3});
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", statuskernels::countAVX2});
+#endif
+    return kernels;
+}
+
+// n statuses drawn at random from codes
+inline string randomStatuses(mt19937& rng, size_t n, const string& codes) {
+    string statuses(n, ' ');
+    for (char& status : statuses) status = codes[rng() % codes.size()];
+    return statuses;
+}
+
+// "P=3 A=1 L=0 E=0 M=0 ?=2", so a failed comparison shows every count
+inline string countsText(const StatusCounts& counts) {
+    string text;
+    for (size_t i = 0; i < statusschema::SLOTS; i++) {
+        if (i > 0) text += ' ';
+        text += i < statusschema::COUNT ? statusschema::STATUSES[i].code : '?';
+        text += '=' + to_string(counts[i]);
+    }
+    return text;
+}
+
+// Count packed statuses with every kernel, over the flat words and chunk
+// by chunk, and compare each with reading them back one by one
+inline void checkKernelCounts(const PackedStatusVector& packed) {
+    StatusCounts expected;
+    for (size_t i = 0; i < packed.size(); i++) expected[statusschema::ordinal(packed.get(i))]++;
+    string context = to_string(packed.size()) + " records: ";
+
+    ChunkedStatusVector chunked;
+    chunked.assign(packed);
+    CHECK_EQ(context + countsText(packed.countStatuses()), context + countsText(expected));
+    CHECK_EQ(context + countsText(chunked.countStatuses()), context + countsText(expected));
+
+    const vector<uint64_t>& words = packed.data();
+    for (const auto& [name, kernel] : availableKernels()) {
+        size_t counts[statusschema::COUNT] = {};
+        kernel(words.data(), words.size(), counts);
+        StatusCounts flat = statuskernels::finishCounts(counts, words.size() * PackedStatusVector::PER_WORD,
+                                                        packed.size());
+        CHECK_EQ(name + ", " + context + countsText(flat), name + ", " + context + countsText(expected));
+
+        size_t chunkCounts[statusschema::COUNT] = {};
+        for (size_t c = 0; c < chunked.chunkCount(); c++) {
+            kernel(chunked.chunkAt(c)->data(), ChunkedStatusVector::CHUNK_WORDS, chunkCounts);
+        }
+        StatusCounts byChunk = statuskernels::finishCounts(
+            chunkCounts, chunked.chunkCount() * ChunkedStatusVector::CHUNK_RECORDS, packed.size());
+        CHECK_EQ(name + " chunks, " + context + countsText(byChunk),
+                 name + " chunks, " + context + countsText(expected));
+    }
+}
+
+inline void checkKernelCounts(const string& statuses) {
+    PackedStatusVector packed;
+    for (char status : statuses) packed.push_back(status);
+    CHECK_EQ(packed.size(), statuses.size());
+    checkKernelCounts(packed);
+}
+
+TEST(count_kernels_match_scalar) {
+    mt19937 rng(4);
+    // Partial last words of every length, word counts that leave 1-3 words
+    // after the vector steps, and partial last chunks
+    for (size_t n : {1, 2, 20, 22, 43, 64, 85, 106, 1000, 1007, 1009, 2017, 3001, 5000}) {
+        checkKernelCounts(randomStatuses(rng, n, "PAL"));
+    }
+    // A single status throughout, where one lane count per word is off by
+    // the padding if anything is
+    for (char status : {'P', 'A', 'L'}) checkKernelCounts(string(1009, status));
+    checkKernelCounts("");
+}
+
+TEST(count_kernels_cover_schema) {
+    mt19937 rng(25);
+    // Every status of the schema, plus codes outside it, which are kept as
+    // unknown
+    for (size_t n : {1, 22, 85, 1009, 2017, 5000}) {
+        checkKernelCounts(randomStatuses(rng, n, "PALEM"));
+        checkKernelCounts(randomStatuses(rng, n, "PALEM?X"));
+    }
+    checkKernelCounts(string(1009, 'E'));
+    checkKernelCounts(string(1009, 'M'));
+    checkKernelCounts(string(1009, '?'));
+
+    // Lane values past the unknown ordinal, as a damaged or foreign binary
+    // file may hold, count as unknown too
+    for (size_t n : {21, 43, 1007, 2017}) {
+        vector<uint64_t> raw((n + PackedStatusVector::PER_WORD - 1) / PackedStatusVector::PER_WORD);
+        for (uint64_t& word : raw) word = ((uint64_t)rng() << 32 | rng()) >> 1;
+        PackedStatusVector packed;
+        packed.assignWords(raw.data(), n);
+        checkKernelCounts(packed);
+    }
+}
+
+// ----- Session files and archives -----
+
+inline vector<Student> makeStudents(size_t count) {
+    vector<Student> students;
+    for (size_t i = 0; i < count; i++) {
+        char index[32];
+        snprintf(index, sizeof(index), "EE%04zu", i);
+        students.push_back(Student(index, "Student " + to_string(i)));
+    }
+    return students;
+}
+
+inline void writeStudents(const vector<Student>& students) {
+    string contents;
+    for (const auto& student : students) contents += student.toString() + "\n";
+    writeFile("students.txt", contents);
+}
+
+// A session over students with every status of `codes` in turn
+inline AttendanceSession markedSession(const vector<Student>& students, const string& codes,
+                                       const string& date = "2026-02-10") {
+    AttendanceSession session("EEE227", date, "09:00", 2);
+    session.initializeRecords(students);
+    for (size_t i = 0; i < students.size(); i++) {
+        session.updateRecord(students[i].getIndex(), codes[i % codes.size()]);
+    }
+    return session;
+}
+
+inline string statusesOf(const AttendanceSession& session) {
+    string statuses;
+    for (size_t i = 0; i < session.getRecordCount(); i++) statuses += session.getStatus(i);
+    return statuses;
+}
+
+inline bool sameRecords(const AttendanceSession& a, const AttendanceSession& b) {
+    if (a.getRecordCount() != b.getRecordCount()) return false;
+    for (size_t i = 0; i < a.getRecordCount(); i++) {
+        if (a.getStudentIndex(i) != b.getStudentIndex(i) || a.getStatus(i) != b.getStatus(i)) return false;
+    }
+    return true;
+}
+
+// A binary session file as an older version wrote it: statuses in
+// bits-bit lanes holding laneCodes.find(status)
+inline string legacyBinaryFile(uint16_t version, unsigned bits, const string& laneCodes,
+                               const AttendanceSession& session) {
+    string meta = session.getCourseCode() + session.getDate() + session.getStartTime();
+    uint32_t metaEnds[3] = {(uint32_t)session.getCourseCode().size(),
+                            (uint32_t)(session.getCourseCode().size() + session.getDate().size()),
+                            (uint32_t)meta.size()};
+    size_t n = session.getRecordCount();
+    string indexes;
+    vector<uint32_t> indexEnds;
+    for (size_t i = 0; i < n; i++) {
+        indexes += session.getStudentIndex(i);
+        indexEnds.push_back((uint32_t)indexes.size());
+    }
+    size_t perWord = 64 / bits;
+    vector<uint64_t> words((n + perWord - 1) / perWord);
+    for (size_t i = 0; i < n; i++) {
+        words[i / perWord] |= (uint64_t)laneCodes.find(session.getStatus(i)) << (bits * (i % perWord));
+    }
+
+    string payload((const char*)metaEnds, sizeof(metaEnds));
+    payload += meta;
+    payload.append((const char*)indexEnds.data(), indexEnds.size() * sizeof(uint32_t));
+    payload += indexes;
+    payload.append((const char*)words.data(), words.size() * sizeof(uint64_t));
+
+    BinarySessionHeader header{};
+    memcpy(header.magic, BINARY_SESSION_MAGIC, 4);
+    header.version = version;
+    header.headerSize = sizeof(header);
+    header.recordCount = (uint32_t)n;
+    header.duration = session.getDuration();
+    header.metaBytes = (uint32_t)meta.size();
+    header.indexBytes = (uint32_t)indexes.size();
+    header.payloadBytes = payload.size();
+    header.checksum = checksum64(payload.data(), payload.size());
+    return string((const char*)&header, sizeof(header)) + payload;
+}
+
+TEST(session_text_and_binary_round_trip) {
+    vector<Student> students = makeStudents(1100);
+    // Sizes either side of a packed word and of a status chunk
+    for (size_t n : {0, 1, 20, 21, 22, 1007, 1008, 1009}) {
+        vector<Student> roster(students.begin(), students.begin() + n);
+        AttendanceSession session = markedSession(roster, "PALEM?L");
+
+        {
+            Console console;
+            CHECK(session.writeToFile());
+            CHECK(session.saveToBinaryFile(session.getBinaryFilename()));
+        }
+        AttendanceSession fromText, fromBinary;
+        string error;
+        CHECK(fromText.readFromFile(session.getFilename(), roster, error));
+        CHECK(fromBinary.readFromFile(session.getBinaryFilename(), roster, error));
+        CHECK(sameRecords(fromText, session));
+        CHECK(sameRecords(fromBinary, session));
+        CHECK(fromBinary.countStatuses() == session.countStatuses());
+        CHECK_EQ(fromBinary.getStartTime(), string("09:00"));
+        CHECK_EQ(fromBinary.getDuration(), 2);
+    }
+}
+
+TEST(binary_reads_older_versions) {
+    vector<Student> students = makeStudents(50);
+    string error;
+
+    // Version 1: 2-bit codes from before the status schema
+    AttendanceSession before = markedSession(students, "PAL?");
+    writeFile("v1.dat", legacyBinaryFile(1, 2, "APL?", before));
+    AttendanceSession v1;
+    CHECK(v1.readFromFile("v1.dat", students, error));
+    CHECK(sameRecords(v1, before));
+
+    // Version 2: schema ordinals in 4-bit lanes
+    AttendanceSession session = markedSession(students, "PALEM?");
+    writeFile("v2.dat", legacyBinaryFile(2, 4, "PALEM?", session));
+    AttendanceSession v2;
+    CHECK(v2.readFromFile("v2.dat", students, error));
+    CHECK(sameRecords(v2, session));
+    CHECK(v2.countStatuses() == session.countStatuses());
+
+    writeFile("v9.dat", legacyBinaryFile(9, 4, "PALEM?", session));
+    AttendanceSession v9;
+    CHECK(!v9.readFromFile("v9.dat", students, error));
+    CHECK_EQ(error, string("Unsupported session file version 9!"));
+
+    // A flipped status bit fails the checksum
+    string damaged = legacyBinaryFile(2, 4, "PALEM?", session);
+    damaged[damaged.size() - 1] ^= 1;
+    writeFile("damaged.dat", damaged);
+    AttendanceSession bad;
+    CHECK(!bad.readFromFile("damaged.dat", students, error));
+    CHECK_EQ(error, string("Session file checksum mismatch!"));
+}
+
+TEST(sessions_on_one_day_keep_their_own_files) {
+    vector<Student> students = makeStudents(12);
+    writeStudents(students);
+    string allPresent = "1\n", allLate = "2\n";
+    for (size_t i = 0; i < students.size(); i++) {
+        allPresent += "P\n";
+        allLate += "L\n";
+    }
+
+    {
+        Console console;
+        AttendanceSystem system;
+        for (const char* time : {"09:00", "14:00"}) {
+            Console script(string("EEE227\n2026-02-10\n") + time + "\n2\n");
+            system.createSession();
+        }
+        {
+            Console script(allPresent);
+            system.markAttendance();
+        }
+        {
+            Console script(allLate);
+            system.markAttendance();
+        }
+        CHECK_EQ(system.saveAllSessions(), (size_t)2);
+    }
+    CHECK(filesystem::exists("session_EEE227_2026_02_10_0900.txt"));
+    CHECK(filesystem::exists("session_EEE227_2026_02_10_1400.txt"));
+
+    // Both come back with their own marks
+    AttendanceSession morning, afternoon;
+    string error;
+    CHECK(morning.readFromFile("session_EEE227_2026_02_10_0900.txt", students, error));
+    CHECK(afternoon.readFromFile("session_EEE227_2026_02_10_1400.txt", students, error));
+    CHECK_EQ(statusesOf(morning), string(students.size(), 'P'));
+    CHECK_EQ(statusesOf(afternoon), string(students.size(), 'L'));
+    CHECK_EQ(afternoon.getStartTime(), string("14:00"));
+
+    Console console;
+    AttendanceSystem reloaded;
+    CHECK_EQ(reloaded.loadAllSessions(), (size_t)2);
+    CHECK_EQ(reloaded.saveAllSessions(), (size_t)0);
+}
+
+TEST(session_file_moves_to_name_with_time) {
+    vector<Student> students = makeStudents(12);
+    writeStudents(students);
+    AttendanceSession session = markedSession(students, "PAL");
+    writeFile("session_EEE227_2026_02_10.txt", session.toText());
+
+    {
+        Console console;
+        AttendanceSystem system;
+        CHECK_EQ(system.loadAllSessions(), (size_t)1);
+        // Loaded under the old name, so it is written under the new one
+        CHECK_EQ(system.saveAllSessions(), (size_t)1);
+    }
+    CHECK(!filesystem::exists("session_EEE227_2026_02_10.txt"));
+    AttendanceSession moved;
+    string error;
+    CHECK(moved.readFromFile("session_EEE227_2026_02_10_0900.txt", students, error));
+    CHECK(sameRecords(moved, session));
+}
+
+TEST(load_all_sessions_adds_only_new_files) {
+    vector<Student> students = makeStudents(6);
+    writeStudents(students);
+    AttendanceSession monday = markedSession(students, "P", "2026-02-09");
+    AttendanceSession tuesday = markedSession(students, "L", "2026-02-10");
+    CHECK(monday.writeToFile());
+    CHECK(tuesday.writeToFile());
+    // Older copies of both under names without the start time
+    writeFile("session_EEE227_2026_02_09.txt", markedSession(students, "A", "2026-02-09").toText());
+    {
+        Console console;
+        CHECK(tuesday.saveToBinaryFile("session_EEE227_2026_02_10.dat"));
+    }
+
+    Console console;
+    AttendanceSystem system;
+    CHECK_EQ(system.loadAllSessions(), (size_t)2);
+    CHECK(console.printed("Loaded 2 of 4 session files"));
+    CHECK(console.printed("(2 already loaded)"));
+    // The files under the sessions' own names were used, so nothing changed
+    CHECK_EQ(system.saveAllSessions(), (size_t)0);
+
+    // Loading again adds only the new file
+    AttendanceSession wednesday = markedSession(students, "E", "2026-02-11");
+    CHECK(wednesday.writeToFile());
+    CHECK_EQ(system.loadAllSessions(), (size_t)1);
+    CHECK_EQ(system.loadAllSessions(), (size_t)0);
+    {
+        Console sessions;
+        system.viewAllSessions();
+        CHECK_EQ(sessions.text(), string("\n--- ALL ATTENDANCE SESSIONS ---\n"
+                                         "1. EEE227 - 2026-02-09 (09:00)\n"
+                                         "2. EEE227 - 2026-02-10 (09:00)\n"
+                                         "3. EEE227 - 2026-02-11 (09:00)\n"));
+    }
+    CHECK_EQ(system.saveAllSessions(), (size_t)0);
+    CHECK_EQ(readFile(monday.getFilename()), monday.toText());
+}
+
+TEST(archive_round_trip) {
+    vector<Student> students = makeStudents(300);
+    vector<Student> fewer(students.begin(), students.begin() + 200);
+    vector<Student> others(students.begin() + 100, students.end());
+
+    // Same roster twice (SAME), a prefix of it (PREFIX), then a roster
+    // that starts part-way through (LIST)
+    vector<AttendanceSession> sessions;
+    sessions.push_back(markedSession(students, "PALEM?", "2026-02-10"));
+    sessions.push_back(markedSession(students, "PPPPPA", "2026-02-17"));
+    sessions.push_back(markedSession(fewer, "LAP", "2026-02-24"));
+    sessions.push_back(markedSession(others, "MEPA", "2026-03-03"));
+    vector<const AttendanceSession*> archived;
+    for (const auto& session : sessions) archived.push_back(&session);
+    writeFile("archive_EEE227.arc", encodeSessionArchive("EEE227", archived));
+
+    SessionArchiveReader reader;
+    CHECK(reader.open("archive_EEE227.arc"));
+    CHECK_EQ(reader.getCourseCode(), string("EEE227"));
+    CHECK_EQ(reader.getSessionCount(), sessions.size());
+    CHECK_EQ(reader.getRosterSize(), students.size());
+    for (const auto& session : sessions) {
+        CHECK(reader.next());
+        CHECK_EQ(reader.getDate(), session.getDate());
+        CHECK(reader.getCounts() == session.countStatuses());
+        CHECK(sameRecords(reader.toSession(), session));
+    }
+    CHECK(!reader.next());
+    CHECK_EQ(reader.getError(), string());
+}
+
+TEST(archive_reads_version_1) {
+    using namespace archive;
+    // Two sessions of three students written with 2-bit codes (A = 0,
+    // P = 1, L = 2, other = 3); each token skips gap unchanged records
+    string out(SESSION_ARCHIVE_MAGIC, 4);
+    uint16_t version = 1;
+    out.append((const char*)&version, sizeof(version));
+    putString(out, "EEE227");
+    putVarint(out, 3);
+    putVarint(out, 0);
+    putString(out, "EE2001");
+    putVarint(out, 5);
+    putString(out, "2");
+    putVarint(out, 5);
+    putString(out, "3");
+    putVarint(out, 2);
+
+    putString(out, "2026-02-10");
+    putString(out, "09:00");
+    putVarint(out, 2);
+    putVarint(out, PREFIX);
+    putVarint(out, 3);
+    putVarint(out, 2);
+    putVarint(out, 0 << 2 | 1); // EE2001 Present
+    putVarint(out, 1 << 2 | 3); // EE2002 unchanged, EE2003 unknown
+
+    putString(out, "2026-02-17");
+    putString(out, "09:00");
+    putVarint(out, 2);
+    putVarint(out, SAME);
+    putVarint(out, 1);
+    putVarint(out, 1 << 2 | 2); // EE2002 Late
+
+    uint64_t checksum = checksum64(out.data(), out.size());
+    out.append((const char*)&checksum, sizeof(checksum));
+    writeFile("archive_EEE227.arc", out);
+
+    SessionArchiveReader reader;
+    CHECK(reader.open("archive_EEE227.arc"));
+    CHECK(reader.next());
+    CHECK_EQ(statusesOf(reader.toSession()), string("PA?"));
+    CHECK_EQ(reader.getCounts().of('P'), (size_t)1);
+    CHECK_EQ(reader.getCounts().unknown(), (size_t)1);
+    CHECK(reader.next());
+    CHECK_EQ(statusesOf(reader.toSession()), string("PL?"));
+    CHECK_EQ(reader.getCounts().of('A'), (size_t)0);
+    CHECK(!reader.next());
+}
+
+// ----- CSV import -----
+
+inline vector<vector<string>> parseCsv(string_view text) {
+    CsvParser parser(text);
+    vector<string_view> fields;
+    vector<vector<string>> rows;
+    while (parser.nextRow(fields)) rows.emplace_back(fields.begin(), fields.end());
+    return rows;
+}
+
+TEST(csv_quoting) {
+    using Rows = vector<vector<string>>;
+    CHECK(parseCsv("a,b\nc,d") == (Rows{{"a", "b"}, {"c", "d"}}));
+    CHECK(parseCsv("\xEF\xBB\xBF" "a,b\r\nc,d\r\n") == (Rows{{"a", "b"}, {"c", "d"}}));
+    // Blank lines are skipped; empty fields are kept
+    CHECK(parseCsv("\n\r\na,,\n\n,b\n") == (Rows{{"a", "", ""}, {"", "b"}}));
+    // Quoted commas, newlines and CRLF inside a field stay in the field
+    CHECK(parseCsv("\"Mensah, Kwame\",x\n") == (Rows{{"Mensah, Kwame", "x"}}));
+    CHECK(parseCsv("\"two\nlines\",\"and\r\nthree\"\r\nnext\n") ==
+          (Rows{{"two\nlines", "and\r\nthree"}, {"next"}}));
+    // "" is a literal quote, also at either end and on its own
+    CHECK(parseCsv("\"say \"\"hi\"\"\",\"\"\"\",\"\"\n") == (Rows{{"say \"hi\"", "\"", ""}}));
+    CHECK(parseCsv("\"\"\"quoted\"\"\"") == (Rows{{"\"quoted\""}}));
+    // Text after a closing quote is dropped, and an unterminated quote
+    // runs to the end of the input
+    CHECK(parseCsv("\"a\"junk,b\n\"open,c") == (Rows{{"a", "b"}, {"open,c"}}));
+    // Unescaped fields of one row stay valid next to escaped ones
+    CHECK(parseCsv("plain,\"x\"\"y\",\"z\"\"\",tail\n") == (Rows{{"plain", "x\"y", "z\"", "tail"}}));
+}
+
+TEST(csv_roster_import) {
+    writeFile("roster.csv",
+              "Name,Index Number\r\n"
+              "\"Mensah, Kwame\",EE2001\r\n"
+              "\"Ama \"\"Ama\"\" Boateng\", EE2002 \r\n"
+              "\"Kojo\nAsare\",EE2003\r\n"
+              "Duplicate,EE2001\r\n"
+              "Missing index,\r\n"
+              "Only one column\r\n"
+              "\r\n");
+    {
+        Console console("roster.csv\n");
+        AttendanceSystem system;
+        system.importRosterCSV();
+        CHECK(console.printed("Imported 3 of 6 rows, 1 already registered, 2 malformed."));
+
+        const StudentRegistry& students = system.getStudents();
+        CHECK_EQ(students.size(), (size_t)3);
+        CHECK(students.get("EE2001") && students.get("EE2001")->getName() == "Mensah, Kwame");
+        CHECK(students.get("EE2002") && students.get("EE2002")->getName() == "Ama \"Ama\" Boateng");
+        CHECK(students.get("EE2003") && students.get("EE2003")->getName() == "Kojo Asare");
+    }
+
+    // The import is saved, and the names read back intact
+    Console console;
+    AttendanceSystem system;
+    CHECK_EQ(system.getStudents().size(), (size_t)3);
+    CHECK(system.getStudents().get("EE2001") && system.getStudents().get("EE2001")->getName() == "Mensah, Kwame");
+}
+
+// ----- Check-in ingestion -----
+
+TEST(ingest_classifies_scans) {
+    vector<Student> students = makeStudents(5);
+    vector<AttendanceSession> sessions;
+    sessions.emplace_back("EEE227", "2026-02-10", "09:00", 2);
+    sessions.emplace_back("EEE229", "2026-02-10", "10:00", 1); // overlaps EEE227
+    sessions.emplace_back("EEE231", "2026-02-10", "14:00", 0); // only the early window
+    sessions.emplace_back("EEE227", "2026-02-11", "09:00", 2); // no scans at all
+    for (auto& session : sessions) session.initializeRecords(students);
+
+    string scans =
+        "EE0000,2026-02-10 08:30\n"           // window opens: Present
+        "EE0001,2026-02-10 09:10:00\n"        // last Present second
+        "EE0002,2026-02-10T09:10:01\n"        // Late...
+        "EE0002,2026-02-10 08:45\r\n"         // ...but an earlier repeat wins
+        "EE0003,2026-02-10 09:20\n"           // Late
+        "EE0003,2026-02-10 09:50,EEE227\n"    // repeat
+        "EE0004,2026-02-10 09:45,EEE229\n"    // course picks the later session
+        "EE0004,2026-02-10 11:00\n"           // both windows closed
+        "EE9999,2026-02-10 09:00\n"           // not on the roster
+        "EE0000,2026-02-10 13:45\n"           // early for the zero-hour session
+        "EE0001,2026-02-10 14:00\n"           // zero-hour session already closed
+        "EE0000,2026-02-12 09:00\n"           // no session that day
+        "\n"
+        "garbage\n"
+        "EE0000,2026-02-10 25:00\n";
+
+    ThreadPool pool(2);
+    CheckInIngestor ingestor(sessions, pool);
+    CheckInStats stats = ingestor.ingest(scans);
+
+    CHECK_EQ(statusesOf(sessions[0]), string("PPPLA"));
+    CHECK_EQ(statusesOf(sessions[1]), string("AAAAP"));
+    CHECK_EQ(statusesOf(sessions[2]), string("PAAAA"));
+    CHECK_EQ(statusesOf(sessions[3]), string("AAAAA"));
+    CHECK_EQ(stats.scans, (size_t)14);
+    CHECK_EQ(stats.present, (size_t)5);
+    CHECK_EQ(stats.late, (size_t)1);
+    CHECK_EQ(stats.duplicates, (size_t)2);
+    CHECK_EQ(stats.unknownStudent, (size_t)1);
+    CHECK_EQ(stats.noSession, (size_t)3);
+    CHECK_EQ(stats.malformed, (size_t)2);
+    CHECK_EQ(stats.sessionsTouched, (size_t)3);
+
+    // Scans only add marks: a record with no scan keeps its hand-made one
+    sessions[3].updateRecord("EE0001", 'E');
+    stats = ingestor.ingest("EE0000,2026-02-11 09:30\n");
+    CHECK_EQ(statusesOf(sessions[3]), string("LEAAA"));
+}
+
+TEST(ingest_empty_input) {
+    vector<Student> students = makeStudents(3);
+    vector<AttendanceSession> sessions;
+    sessions.emplace_back("EEE227", "2026-02-10", "09:00", 2);
+    sessions[0].initializeRecords(students);
+    sessions[0].updateRecord("EE0002", 'M');
+    sessions[0].publish();
+    SessionSnapshot::Ref before = sessions[0].snapshot();
+
+    ThreadPool pool(2);
+    CheckInIngestor ingestor(sessions, pool);
+    for (string_view text : {string_view(), string_view("\n\r\n\n")}) {
+        CheckInStats stats = ingestor.ingest(text);
+        CHECK_EQ(stats.scans, (size_t)0);
+        CHECK_EQ(stats.present + stats.late + stats.malformed + stats.noSession, (size_t)0);
+        CHECK_EQ(stats.sessionsTouched, (size_t)0);
+    }
+    // Nothing was applied, so no new version was published
+    CHECK_EQ(statusesOf(sessions[0]), string("AAM"));
+    CHECK(sessions[0].snapshot() == before);
+
+    // No sessions at all: every scan is outside a session
+    vector<AttendanceSession> none;
+    CheckInIngestor idle(none, pool);
+    CheckInStats stats = idle.ingest("EE0000,2026-02-10 09:00\n");
+    CHECK_EQ(stats.noSession, (size_t)1);
+    CHECK_EQ(stats.sessionsTouched, (size_t)0);
+}
+
+// ----- Check-in daemon -----
+
+// The daemon's reply to one request line
+inline string reply(AttendanceSystem& system, const string& request) {
+    string replies;
+    if (request.compare(0, 5, "MARK ") == 0) {
+        system.handleMarks({request}, 0, 1, replies);
+    } else {
+        system.handleCommand(request, replies);
+    }
+    return replies;
+}
+
+TEST(daemon_open_sessions) {
+    writeStudents(makeStudents(5));
+    Console console;
+    AttendanceSystem system;
+
+    // The load generator's sessions: one course and day, an hour apart
+    CHECK_EQ(reply(system, "OPEN LOADTEST 2026-01-01 08:00 1"), string("OK 1\n"));
+    CHECK_EQ(reply(system, "OPEN LOADTEST 2026-01-01 09:00 1"), string("OK 2\n"));
+    CHECK_EQ(reply(system, "OPEN LOADTEST 2026-01-01 08:00 1"), string("OK 1\n"));
+    // Another spelling of 08:00 would overwrite session 1's file
+    CHECK_EQ(reply(system, "OPEN LOADTEST 2026-01-01 0800 1"), string("ERR session file in use\n"));
+
+    for (const char* hours : {"2abc", "-1", "0", "x", "99999999999"}) {
+        CHECK_EQ(reply(system, string("OPEN LOADTEST 2026-01-01 10:00 ") + hours), string("ERR bad duration\n"));
+    }
+
+    CHECK_EQ(reply(system, "MARK 2 EE0003 L"), string("OK\n"));
+    CHECK_EQ(reply(system, "SAVE"), string("OK 2\n"));
+    AttendanceSession later;
+    string error;
+    CHECK(later.readFromFile("session_LOADTEST_2026_01_01_0900.txt", {}, error));
+    CHECK_EQ(statusesOf(later), string("AAALA"));
+    CHECK(filesystem::exists("session_LOADTEST_2026_01_01_0800.txt"));
+}
+
+// ----- Session snapshots -----
+
+TEST(snapshot_keeps_its_version) {
+    vector<Student> students = makeStudents(3 * ChunkedStatusVector::CHUNK_RECORDS + 5);
+    AttendanceSession session("EEE227", "2026-02-10", "09:00", 2);
+    session.initializeRecords(students);
+    SessionSnapshot::Ref first = session.current();
+    uint64_t version = first->getVersion();
+
+    // Pending marks are not visible until published
+    size_t last = students.size() - 1;
+    session.updateRecord(students[1].getIndex(), 'P');
+    session.updateRecord(students[last].getIndex(), 'L');
+    CHECK(session.snapshot() == first);
+    CHECK_EQ(session.getStatus(1), 'P');
+    CHECK_EQ(first->getStatus(1), 'A');
+
+    SessionSnapshot::Ref second = session.current();
+    CHECK_EQ(second->getVersion(), version + 1);
+    CHECK(session.current() == second); // nothing pending: no new version
+    CHECK_EQ(second->getStatus(1), 'P');
+    CHECK_EQ(second->getStatus(last), 'L');
+    CHECK_EQ(first->getStatus(1), 'A');
+    CHECK_EQ(first->getStatus(last), 'A');
+    CHECK_EQ(first->countStatuses().of('A'), students.size());
+    CHECK_EQ(second->countStatuses().of('P'), (size_t)1);
+
+    // Only the chunk that is written is copied; the rest stay shared
+    size_t shared = session.memoryBytes();
+    session.updateRecord(students[2].getIndex(), 'E');
+    CHECK_EQ(session.memoryBytes() - shared, sizeof(SessionSnapshot::Chunk));
+    CHECK_EQ(second->getStatus(2), 'A');
+
+    // New roster entries appear in the next version only
+    Roster::Ref roster = session.getRoster();
+    vector<uint32_t> ids;
+    for (size_t i = 0; i < roster->size(); i++) ids.push_back((*roster)[i]);
+    ids.push_back(Student("EE9999", "Late Registration").getIndexId());
+    CHECK_EQ(session.extendRoster(Roster::fromIds(ids)), (size_t)1);
+    CHECK_EQ(second->getRecordCount(), students.size());
+    CHECK_EQ(session.snapshot()->getRecordCount(), students.size() + 1);
+    CHECK_EQ(session.snapshot()->getStatus(2), 'E');
+
+    // A snapshot outlives its session
+    SessionSnapshot::Ref kept = session.snapshot();
+    session = AttendanceSession();
+    CHECK_EQ(kept->getStatus(1), 'P');
+    CHECK_EQ(kept->countStatuses().of('E'), (size_t)1);
+}
+
+TEST(session_copies_are_independent) {
+    vector<Student> students = makeStudents(2 * ChunkedStatusVector::CHUNK_RECORDS + 5);
+    AttendanceSession session("EEE227", "2026-02-10", "09:00", 2);
+    session.initializeRecords(students);
+    session.current();
+    // Chunk 0 is now the session's own copy, chunks 1 and 2 are still
+    // shared with the published version
+    session.updateRecord(students[0].getIndex(), 'P');
+
+    AttendanceSession copy = session;
+    AttendanceSession assigned;
+    assigned = session;
+    for (AttendanceSession* other : {&copy, &assigned}) {
+        for (size_t i : {(size_t)1, students.size() - 1}) {
+            other->updateRecord(students[i].getIndex(), 'L');
+        }
+    }
+    session.updateRecord(students[2].getIndex(), 'E');
+    session.updateRecord(students[students.size() - 2].getIndex(), 'M');
+
+    size_t last = students.size() - 1;
+    CHECK_EQ(string({session.getStatus(0), session.getStatus(1), session.getStatus(2)}), string("PAE"));
+    CHECK_EQ(session.getStatus(last - 1), 'M');
+    CHECK_EQ(session.getStatus(last), 'A');
+    CHECK_EQ(session.countStatuses().of('L'), (size_t)0);
+    for (AttendanceSession* other : {&copy, &assigned}) {
+        CHECK_EQ(string({other->getStatus(0), other->getStatus(1), other->getStatus(2)}), string("PLA"));
+        CHECK_EQ(other->getStatus(last - 1), 'A');
+        CHECK_EQ(other->getStatus(last), 'L');
+        CHECK_EQ(other->countStatuses().of('A'), students.size() - 3);
+    }
+    CHECK_EQ(session.snapshot()->countStatuses().of('A'), students.size());
+}
+
+TEST(snapshot_is_never_torn) {
+    // Every published version is all Present or all Late; a reader must
+    // never see a mix, whichever chunks the writer is copying
+    vector<Student> students = makeStudents(3 * ChunkedStatusVector::CHUNK_RECORDS + 5);
+    AttendanceSession session("EEE227", "2026-02-10", "09:00", 2);
+    session.initializeRecords(students);
+    session.applyStatuses(vector<char>(students.size(), 'P'));
+
+    atomic<bool> done{false};
+    atomic<size_t> torn{0}, seen{0};
+    vector<thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&] {
+            while (!done) {
+                SessionSnapshot::Ref version = session.snapshot();
+                char first = version->getStatus(0);
+                StatusCounts counts = version->countStatuses();
+                if (counts.of(first) != version->getRecordCount()) torn++;
+                for (size_t i = 0; i < version->getRecordCount(); i += 97) {
+                    if (version->getStatus(i) != first) torn++;
+                }
+                seen++;
+            }
+        });
+    }
+    for (int i = 0; i < 400; i++) {
+        session.applyStatuses(vector<char>(students.size(), i % 2 ? 'P' : 'L'));
+    }
+    while (seen < 100) this_thread::yield();
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    CHECK_EQ(torn.load(), (size_t)0);
+    CHECK(seen.load() > 0);
+}
+
+// ----- Marking -----
+
+TEST(batch_updates) {
+    vector<Student> students = makeStudents(30);
+    AttendanceSession session("EEE227", "2026-02-10", "09:00", 2);
+    session.initializeRecords(students);
+    uint64_t version = session.snapshot()->getVersion();
+
+    // Matched by index number in any order; a repeated student takes the
+    // last status, and unknown students are listed back
+    vector<StatusUpdate> updates = {{"EE0029", 'L'}, {"EE0003", 'P'}, {"XX0001", 'P'},
+                                    {"EE0003", 'E'}, {"EE0000", 'M'}, {"", 'P'}};
+    vector<string> unmatched;
+    CHECK_EQ(session.applyUpdates(updates, &unmatched), (size_t)4);
+    CHECK(unmatched == vector<string>({"XX0001", ""}));
+    // The whole batch is one new version
+    CHECK_EQ(session.snapshot()->getVersion(), version + 1);
+    CHECK_EQ(session.snapshot()->getStatus(3), 'E');
+    string expected(30, 'A');
+    expected[0] = 'M';
+    expected[3] = 'E';
+    expected[29] = 'L';
+    CHECK_EQ(statusesOf(session), expected);
+
+    // Position-aligned statuses: '\0' keeps a record, entries past the
+    // roster are ignored
+    vector<char> marks(40, '\0');
+    marks[1] = 'P';
+    marks[3] = 'A';
+    marks[35] = 'P';
+    CHECK_EQ(session.applyStatuses(marks), (size_t)2);
+    expected[1] = 'P';
+    expected[3] = 'A';
+    CHECK_EQ(statusesOf(session), expected);
+    CHECK_EQ(session.snapshot()->getVersion(), version + 2);
+
+    // Nothing applied: no new version
+    CHECK_EQ(session.applyUpdates({{"XX0002", 'P'}}), (size_t)0);
+    CHECK_EQ(session.applyStatuses(vector<char>(30, '\0')), (size_t)0);
+    CHECK_EQ(session.snapshot()->getVersion(), version + 2);
+    CHECK(session.countStatuses() == session.snapshot()->countStatuses());
+}
+
+// ----- Rosters -----
+
+TEST(rosters_shared_across_registrations) {
+    vector<Student> students = makeStudents(2100);
+    StudentRegistry registry;
+    for (const auto& student : students) registry.add(student);
+    Roster::Ref before = registry.roster();
+    CHECK(registry.roster() == before);
+
+    // Sessions take the registry's version by reference
+    AttendanceSession first("EEE227", "2026-02-10", "09:00", 2);
+    AttendanceSession second("EEE227", "2026-02-11", "09:00", 2);
+    first.initializeRecords(before);
+    second.initializeRecords(registry.roster());
+    CHECK(first.getRoster() == before && second.getRoster() == before);
+    first.updateRecord("EE0005", 'P');
+
+    // A registration makes a new version; the old one is unchanged
+    CHECK(registry.add(Student("EE9000", "Late Registration")));
+    Roster::Ref after = registry.roster();
+    CHECK(after != before);
+    CHECK_EQ(before->size(), (size_t)2100);
+    CHECK_EQ(after->size(), (size_t)2101);
+    CHECK(before->isPrefixOf(*after));
+    CHECK_EQ(after->indexAt(2100), string_view("EE9000"));
+    CHECK_EQ(after->find("EE9000"), 2100);
+    CHECK_EQ(before->find("EE9000"), -1);
+
+    // A session moves to the new version when asked, keeping its marks;
+    // the other stays on the old one
+    CHECK_EQ(first.extendRoster(after), (size_t)1);
+    CHECK(first.getRoster() == after);
+    CHECK_EQ(first.getStatus(5), 'P');
+    CHECK_EQ(first.getStatus(2100), 'A');
+    CHECK_EQ(first.snapshot()->getRecordCount(), (size_t)2101);
+    CHECK(second.getRoster() == before);
+    CHECK_EQ(second.getRecordCount(), (size_t)2100);
+    CHECK_EQ(second.extendRoster(Roster::fromIds({(*after)[1]})), (size_t)0);
+
+    // A session read back from its file shares the current version
+    CHECK(first.writeToFile());
+    AttendanceSession loaded;
+    string error;
+    CHECK(loaded.readFromFile(first.getFilename(), registry.all(), error));
+    CHECK(loaded.getRoster() != after);
+    CHECK(loaded.shareRoster(after));
+    CHECK(loaded.getRoster() == after);
+    CHECK(!second.shareRoster(after));
+
+    // Through the menus: marking a session picks up students registered
+    // since it was created
+    writeStudents(makeStudents(3));
+    Console console;
+    AttendanceSystem system;
+    {
+        Console script("EEE227\n2026-02-10\n09:00\n2\nEE0100\nNew Student\n1\nP\nP\nP\nL\n");
+        system.createSession();
+        system.registerStudent();
+        system.markAttendance();
+        CHECK(script.printed("Added 1 students registered since this session was created."));
+        CHECK(script.printed("Attendance marked successfully!"));
+    }
+    CHECK_EQ(system.saveAllSessions(), (size_t)1);
+    AttendanceSession onDisk;
+    CHECK(onDisk.readFromFile("session_EEE227_2026_02_10_0900.txt", system.getStudents().all(), error));
+    CHECK_EQ(statusesOf(onDisk), string("PPPL"));
+}
+
+// ----- Attendance analytics -----
+
+// Index numbers at positions of a course's counters
+inline vector<string> indexesAt(const CourseAnalytics& course, const vector<size_t>& positions) {
+    vector<string> indexes;
+    for (size_t pos : positions) indexes.push_back(string(course.indexAt(pos)));
+    return indexes;
+}
+
+TEST(analytics_follow_edits) {
+    vector<Student> students = makeStudents(4);
+    AttendanceAnalytics analytics;
+    vector<AttendanceSession> sessions;
+    // One column per session: EE0000 PPP, EE0001 PAA, EE0002 AAM, EE0003 LEA
+    for (const char* codes : {"PPAL", "PAAE", "PAMA"}) {
+        sessions.push_back(markedSession(students, codes));
+        sessions.back().attachAnalytics(&analytics);
+    }
+    AttendanceSession other("EEE300", "2026-02-10", "14:00", 1);
+    other.initializeRecords(students);
+    other.attachAnalytics(&analytics);
+
+    const CourseAnalytics* course = analytics.findCourse("EEE227");
+    CHECK(course != nullptr);
+    if (!course) return;
+    CHECK_EQ(course->studentCount(), (size_t)4);
+    CHECK_EQ(analytics.findCourse("EEE300")->studentCount(), (size_t)4);
+    CHECK_EQ(course->statsAt(course->belowThreshold(75)[0]).of('A'), (size_t)2);
+    CHECK(indexesAt(*course, course->belowThreshold(75)) == vector<string>({"EE0002", "EE0001", "EE0003"}));
+    CHECK(indexesAt(*course, course->top(2)) == vector<string>({"EE0000", "EE0003"}));
+
+    // Single marks and batches: EE0002 becomes APP (66.7%), EE0001 AAP
+    // (33.3%)
+    sessions[1].updateRecord("EE0002", 'P');
+    sessions[2].applyUpdates({{"EE0002", 'P'}, {"EE0001", 'P'}});
+    sessions[0].applyStatuses({'\0', 'A'});
+    CHECK(indexesAt(*course, course->belowThreshold(75)) == vector<string>({"EE0001", "EE0003", "EE0002"}));
+
+    // A session reloaded from a file is counted out and in again:
+    // EE0001 now EAP (50%), EE0002 still APP, EE0003 AEA (0%)
+    writeFile("reload.txt", "COURSE:EEE227\nDATE:2026-02-12\nTIME:09:00\nDURATION:2\n"
+                            "ATTENDANCE_RECORDS:\nEE0000,L\nEE0001,E\nEE0002,A\nEE0003,A\n");
+    string error;
+    CHECK(sessions[0].readFromFile("reload.txt", students, error));
+    CHECK(indexesAt(*course, course->belowThreshold(75)) == vector<string>({"EE0003", "EE0001", "EE0002"}));
+
+    // A record added for a newly registered student; of two at 100% the
+    // one with more sessions attended ranks first
+    sessions[2].addRecord(AttendanceRecord("EE0004", 'P'));
+    CHECK_EQ(course->studentCount(), (size_t)5);
+    CHECK(indexesAt(*course, course->top(3)) == vector<string>({"EE0000", "EE0004", "EE0002"}));
+    // The other course never saw any of it
+    CHECK_EQ(analytics.findCourse("EEE300")->belowThreshold(75).size(), (size_t)4);
+}
+
+// ----- Session catalog -----
+
+TEST(catalog_evicts_least_recently_used) {
+    vector<Student> students = makeStudents(3000);
+    vector<string> files;
+    vector<StatusCounts> counts;
+    for (int day = 1; day <= 8; day++) {
+        char date[16];
+        snprintf(date, sizeof(date), "2026-03-%02d", day);
+        AttendanceSession session = markedSession(students, string("PALEM").substr(0, 1 + day % 5), date);
+        CHECK(session.writeToFile());
+        files.push_back(session.getFilename());
+        counts.push_back(session.countStatuses());
+    }
+
+    ThreadPool pool(2);
+    vector<string> errors;
+    SessionCatalog catalog(SIZE_MAX, "test.manifest");
+    CHECK_EQ(catalog.refresh(files, pool, errors), files.size());
+    CHECK(errors.empty());
+    CHECK_EQ(catalog.getResidentCount(), (size_t)0);
+    for (size_t i = 0; i < files.size(); i++) CHECK(catalog.header(i).counts == counts[i]);
+
+    // Bodies come in on first use and stay while they fit
+    string error;
+    vector<size_t> bytes;
+    for (size_t i = 0; i < 5; i++) {
+        size_t before = catalog.getResidentBytes();
+        const AttendanceSession* body = catalog.load(i, students, error);
+        CHECK(body && body->countStatuses() == counts[i]);
+        bytes.push_back(catalog.getResidentBytes() - before);
+    }
+    CHECK_EQ(catalog.getResidentCount(), (size_t)5);
+    CHECK_EQ(catalog.getMisses(), (size_t)5);
+    const AttendanceSession* first = catalog.load(0, students, error);
+    CHECK_EQ(catalog.getHits(), (size_t)1);
+
+    // Over the budget, the least recently used go first: session 1, since
+    // session 0 was just used
+    catalog.setBudget(catalog.getResidentBytes() - bytes[1]);
+    CHECK_EQ(catalog.getEvictions(), (size_t)1);
+    CHECK_EQ(catalog.getResidentCount(), (size_t)4);
+    CHECK(catalog.getResidentBytes() <= catalog.getBudget());
+    CHECK(catalog.load(0, students, error) == first);
+    CHECK_EQ(catalog.getHits(), (size_t)2);
+    // Reading session 1 back pushes out session 2, now the oldest
+    CHECK(catalog.load(1, students, error) != nullptr);
+    CHECK_EQ(catalog.getMisses(), (size_t)6);
+    CHECK(catalog.getResidentBytes() <= catalog.getBudget());
+    size_t misses = catalog.getMisses();
+    catalog.load(3, students, error);
+    catalog.load(4, students, error);
+    CHECK_EQ(catalog.getMisses(), misses);
+    catalog.load(2, students, error);
+    CHECK_EQ(catalog.getMisses(), misses + 1);
+
+    // However small the budget, the session just loaded stays
+    catalog.setBudget(1);
+    CHECK_EQ(catalog.getResidentCount(), (size_t)1);
+    for (size_t i = 0; i < files.size(); i++) {
+        const AttendanceSession* body = catalog.load(i, students, error);
+        CHECK(body && body->countStatuses() == counts[i]);
+        CHECK_EQ(catalog.getResidentCount(), (size_t)1);
+    }
+
+    // Unchanged files are known from the manifest on the next refresh;
+    // a rewritten one is read again
+    AttendanceSession changed = markedSession(students, "L", "2026-03-02");
+    CHECK(changed.writeToFile());
+    SessionCatalog reopened(SIZE_MAX, "test.manifest");
+    CHECK_EQ(reopened.refresh(files, pool, errors), (size_t)1);
+    CHECK(reopened.header(1).counts == changed.countStatuses());
+    CHECK(reopened.header(0).counts == counts[0]);
+}
+
+// ----- Reports -----
+
+// One row of an attendance list
+inline string listRow(const string& index, const string& name, const string& status) {
+    return index + string(15 - index.size(), ' ') + name + string(25 - name.size(), ' ') + status +
+           string(10 - status.size(), ' ') + "\n";
+}
+
+TEST(attendance_list_joins_names) {
+    StudentRegistry registry;
+    registry.add(Student("EE2001", "Kwame Mensah"));
+    registry.add(Student("EE2002", "Ama Boateng"));
+    registry.add(Student("EE2003", "Kojo Asare"));
+    string heading = "\nATTENDANCE LIST:\n" + listRow("Index Number", "Student Name", "Status") +
+                     string(50, '-') + "\n";
+
+    // Records in registration order: joined by position
+    AttendanceSession inOrder("EEE227", "2026-02-10", "09:00", 2);
+    inOrder.initializeRecords(registry.all());
+    inOrder.updateRecord("EE2002", 'L');
+    ostringstream first;
+    {
+        ReportWriter out(first);
+        inOrder.displayAttendance(registry, out);
+    }
+    CHECK_EQ(first.str(), heading + listRow("EE2001", "Kwame Mensah", "Absent") +
+                              listRow("EE2002", "Ama Boateng", "Late") +
+                              listRow("EE2003", "Kojo Asare", "Absent"));
+
+    // Records in another order, and one for a student not registered:
+    // joined through the hash index, or shown as Unknown
+    writeFile("session.txt", "COURSE:EEE227\nDATE:2026-02-11\nTIME:09:00\nDURATION:2\n"
+                             "ATTENDANCE_RECORDS:\nEE2003,P\nEE9999,E\nEE2001,M\n");
+    AttendanceSession shuffled;
+    string error;
+    CHECK(shuffled.readFromFile("session.txt", registry.all(), error));
+    ostringstream second;
+    {
+        ReportWriter out(second);
+        shuffled.snapshot()->displayAttendance(registry, out);
+    }
+    CHECK_EQ(second.str(), heading + listRow("EE2003", "Kojo Asare", "Present") +
+                               listRow("EE9999", "Unknown", "Excused") +
+                               listRow("EE2001", "Kwame Mensah", "Medical"));
+}
+
+TEST(report_writer_to_file) {
+    Console console;
+    // Formatting, and more than one buffer's worth, goes to the file only
+    string expected;
+    {
+        ReportWriter out;
+        CHECK(out.openFile("report.txt"));
+        CHECK(out.isFile());
+        out.field("EE2001", 10).field("Kwame", 8).number((size_t)42).put(' ').fixed(87.456, 1).line();
+        expected += "EE2001    Kwame   42 87.5\n";
+        for (int i = 0; i < 20000; i++) {
+            out << "row " << i << '\n';
+            expected += "row " + to_string(i) + "\n";
+        }
+        string wide(100000, 'x');
+        out.text(wide).line();
+        expected += wide + "\n";
+        out.close();
+        CHECK(!out.isFile());
+        // Back on the screen after close()
+        out << "on screen\n";
+    }
+    CHECK_EQ(console.text(), string("on screen\n"));
+    CHECK(readFile("report.txt") == expected);
+
+    // Appending keeps what is there; a file that cannot be opened leaves
+    // the writer on the screen
+    {
+        ReportWriter out;
+        CHECK(out.openFile("report.txt", true));
+        out << "appended\n";
+        CHECK(!out.openFile("no_such_dir/report.txt"));
+        CHECK(!out.isFile());
+    }
+    CHECK(readFile("report.txt") == expected + "appended\n");
+
+    // Reports from the menus, once a report file is chosen, are appended to it
+    writeStudents(makeStudents(3));
+    AttendanceSystem system;
+    {
+        Console script("students.report\n");
+        system.setReportOutput();
+        CHECK(script.printed("Reports will be written to students.report"));
+    }
+    for (int i = 0; i < 2; i++) {
+        Console report;
+        system.viewAllStudents();
+        CHECK(report.printed("Report written to students.report"));
+        CHECK(!report.printed("Student 1"));
+    }
+    string listing = "Index Number   Student Name             \n" + string(40, '-') + "\n" +
+                     "EE0000         Student 0                \n"
+                     "EE0001         Student 1                \n"
+                     "EE0002         Student 2                \n"
+                     "\nTotal: 3 students\n";
+    CHECK_EQ(readFile("students.report"), listing + listing);
+}
+
+TEST(summary_report_is_the_same_on_any_pool) {
+    vector<Student> students = makeStudents(40);
+    const char* courses[] = {"EEE227", "EEE300", "MTH201"};
+    // Rates repeat within each course, so the lowest session is a tie
+    const char* codes[] = {"PA", "P", "AP", "PPPA", "L", "PAPA", "PAAA"};
+    vector<AttendanceSession> sessions;
+    for (int i = 0; i < 42; i++) {
+        char date[16];
+        snprintf(date, sizeof(date), "2026-%02d-%02d", 2 + i / 28, 1 + i % 28);
+        sessions.emplace_back(courses[i % 3], date, "09:00", 2);
+        sessions.back().initializeRecords(students);
+        const string pattern = codes[i % 7];
+        for (size_t s = 0; s < students.size(); s++) {
+            sessions.back().updateRecord(students[s].getIndex(), pattern[s % pattern.size()]);
+        }
+    }
+    vector<SessionSnapshot::Ref> versions;
+    for (auto& session : sessions) versions.push_back(session.current());
+
+    // Rolled up one session at a time, earliest first
+    map<string, CourseRollup> expected;
+    StatusCounts totals;
+    for (size_t i = 0; i < versions.size(); i++) {
+        StatusCounts counts = versions[i]->countStatuses();
+        CourseRollup& course = expected[versions[i]->getCourseCode()];
+        if (course.sessions == 0 || counts.rate() < course.lowestRate) {
+            course.lowestSession = i;
+            course.lowestRate = counts.rate();
+        }
+        course.sessions++;
+        course.counts += counts;
+        totals += counts;
+    }
+
+    string first;
+    for (size_t workers : {1, 2, 5, 11}) {
+        ThreadPool pool(workers);
+        SummaryReport report;
+        report.build(versions, pool);
+        CHECK(report.getTotals() == totals);
+        CHECK_EQ(report.getCourses().size(), expected.size());
+        for (const auto& course : report.getCourses()) {
+            const CourseRollup& want = expected[course.courseCode];
+            CHECK_EQ(course.sessions, want.sessions);
+            CHECK(course.counts == want.counts);
+            CHECK_EQ(course.lowestSession, want.lowestSession);
+        }
+        ostringstream text;
+        {
+            ReportWriter out(text);
+            report.render(pool, out);
+        }
+        if (first.empty()) first = text.str();
+        CHECK_EQ(text.str(), first);
+    }
+    // Session summaries come out in session order
+    size_t at = 0;
+    for (const auto& version : versions) {
+        at = first.find(version->getDate(), at);
+        CHECK(at != string::npos);
+    }
+}
+
+// ----- Autosave -----
+
+// Session files the autosaver has written, from the menu's status line
+inline size_t autosaveWrites(AttendanceSystem& system) {
+    Console console;
+    system.displayMenu();
+    string text = console.text();
+    size_t at = text.find("Autosave: every ");
+    if (at == string::npos) return SIZE_MAX;
+    at = text.find('(', at);
+    return at == string::npos ? SIZE_MAX : (size_t)stoul(text.substr(at + 1));
+}
+
+inline size_t tmpFiles() {
+    size_t count = 0;
+    for (const auto& entry : filesystem::directory_iterator(".")) {
+        if (entry.path().extension() == ".tmp") count++;
+    }
+    return count;
+}
+
+// Autosave every few milliseconds, and after every published version
+inline AutosavePolicy eagerAutosave() {
+    AutosavePolicy policy;
+    policy.interval = chrono::milliseconds(2);
+    policy.maxChanges = 1;
+    return policy;
+}
+
+TEST(autosave_skips_loaded_and_saved_sessions) {
+    vector<Student> students = makeStudents(40);
+    writeStudents(students);
+    for (int day = 1; day <= 200; day++) {
+        char date[16];
+        snprintf(date, sizeof(date), "2026-%02d-%02d", 1 + day / 28, 1 + day % 28);
+        AttendanceSession session = markedSession(students, "PAL", date);
+        CHECK(session.writeToFile());
+    }
+
+    Console console;
+    AttendanceSystem system;
+    system.startAutosave(eagerAutosave());
+    // Sessions are added while the autosaver flushes in between; a loaded
+    // session is already on disk and must not be written again
+    CHECK_EQ(system.loadAllSessions(), (size_t)200);
+    this_thread::sleep_for(chrono::milliseconds(100));
+    CHECK_EQ(autosaveWrites(system), (size_t)0);
+
+    CHECK_EQ(system.saveAllSessions(), (size_t)0);
+    CHECK_EQ(tmpFiles(), (size_t)0);
+}
+
+TEST(autosave_skips_demo_session_once_saved) {
+    Console console;
+    AttendanceSystem system;
+    // Flushes only on the interval, so the demo's own save comes first
+    AutosavePolicy policy;
+    policy.interval = chrono::milliseconds(500);
+    policy.maxChanges = 0;
+    system.startAutosave(policy);
+
+    system.addDemoData();
+    CHECK(console.printed("Saved 1 changed sessions"));
+    CHECK(filesystem::exists("session_EEE227_2026_02_10_0900.txt"));
+    // The autosaver knows that version is on disk and does not write it again
+    this_thread::sleep_for(chrono::milliseconds(1200));
+    CHECK_EQ(autosaveWrites(system), (size_t)0);
+    CHECK_EQ(system.saveAllSessions(), (size_t)0);
+}
+
+TEST(autosave_and_save_leave_latest_version) {
+    vector<Student> students = makeStudents(30);
+    writeStudents(students);
+    AttendanceSession session = markedSession(students, "A");
+    CHECK(session.writeToFile());
+
+    string allPresent = "1\n", allLate = "1\n";
+    for (size_t i = 0; i < students.size(); i++) {
+        allPresent += "P\n";
+        allLate += "L\n";
+    }
+
+    {
+        Console console;
+        AttendanceSystem system;
+        system.startAutosave(eagerAutosave());
+        system.loadAllSessions();
+        // Marking from this thread while the autosaver writes, with manual
+        // saves in between
+        for (int round = 0; round < 60; round++) {
+            {
+                Console script(round % 2 ? allLate : allPresent);
+                system.markAttendance();
+            }
+            if (round % 7 == 0) system.saveAllSessions();
+            this_thread::sleep_for(chrono::milliseconds(round % 3));
+        }
+        // The last round marked everyone Late
+        system.saveAllSessions();
+        CHECK(autosaveWrites(system) > 0);
+    }
+
+    AttendanceSession onDisk;
+    string error;
+    CHECK(onDisk.readFromFile(session.getFilename(), students, error));
+    CHECK_EQ(statusesOf(onDisk), string(students.size(), 'L'));
+    CHECK_EQ(tmpFiles(), (size_t)0);
+}
+
+// ==============================
+// MAIN
+// ==============================
+int main(int argc, char** argv) {
+    filesystem::path original = filesystem::current_path();
+    filesystem::path scratchRoot = filesystem::temp_directory_path() /
+        ("attendance_tests_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+
+    size_t run = 0, failed = 0;
+    for (const TestCase& test : testCases()) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) {
+            if (strstr(test.name, argv[i])) selected = true;
+        }
+        if (!selected) continue;
+
+        filesystem::path scratch = scratchRoot / test.name;
+        filesystem::create_directories(scratch);
+        filesystem::current_path(scratch);
+
+        size_t before = checksFailed;
+        try {
+            test.run();
+        } catch (const exception& e) {
+            checksFailed++;
+            cerr << test.name << ": unexpected exception: " << e.what() << endl;
+        }
+        filesystem::current_path(original);
+
+        run++;
+        bool passed = checksFailed == before;
+        if (!passed) failed++;
+        cout << (passed ? "PASS " : "FAIL ") << test.name << endl;
+    }
+
+    filesystem::remove_all(scratchRoot);
+    cout << run - failed << " of " << run << " tests passed." << endl;
+    return failed == 0 ? 0 : 1;
+}